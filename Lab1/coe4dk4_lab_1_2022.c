@@ -24,7 +24,9 @@
 /*******************************************************************************/
 
 #include <stdio.h>
+#include <math.h>
 #include "simlib.h"
+#include "lindley.h"
 
 /*******************************************************************************/
 
@@ -40,6 +42,79 @@
 
 #define BLIP_RATE 10000
 
+/* Use the Lindley recursion (lindley.c) instead of the event loop below. */
+#define USE_LINDLEY_RECURSION 1
+
+/* Run LINDLEY_REPLICATIONS replications and report confidence intervals. */
+#define USE_REPLICATIONS 0
+
+/*
+ * Find the departure times with the time-parallel scan in simlib.c on
+ * NUMBER_OF_THREADS threads (0 for one per core).
+ */
+#define USE_TIME_PARALLEL_SCAN 0
+#define NUMBER_OF_THREADS 0
+
+/*******************************************************************************/
+
+/*
+ * Print the mean across the replications of one output, with the half-width
+ * of its 95% confidence interval.
+ */
+
+static void
+output_replication_statistic(const char * name, double * values)
+{
+  double mean = 0.0, variance = 0.0;
+  int i;
+
+  for(i=0; i<LINDLEY_REPLICATIONS; i++) mean += values[i];
+  mean /= LINDLEY_REPLICATIONS;
+
+  for(i=0; i<LINDLEY_REPLICATIONS; i++)
+    variance += (values[i] - mean) * (values[i] - mean);
+  variance /= (LINDLEY_REPLICATIONS - 1);
+
+  printf("%s = %f (95%% CI +/- %f)\n", name, mean,
+	 student_t_quantile(LINDLEY_REPLICATIONS - 1) *
+	 sqrt(variance / LINDLEY_REPLICATIONS));
+}
+
+/*
+ * Run LINDLEY_REPLICATIONS independent replications with
+ * lindley_run_replications, each on its own substream of RANDOM_SEED, and
+ * print the results of each along with confidence intervals across them.
+ */
+
+static void
+run_replications(void)
+{
+  Lindley_Results results[LINDLEY_REPLICATIONS];
+  double utilization[LINDLEY_REPLICATIONS];
+  double mean_number[LINDLEY_REPLICATIONS];
+  double mean_delay[LINDLEY_REPLICATIONS];
+  int i;
+
+  lindley_run_replications((long int) NUMBER_TO_SERVE,
+			   (double) 1/ARRIVAL_RATE, SERVICE_TIME, RANDOM_SEED,
+			   results);
+
+  for(i=0; i<LINDLEY_REPLICATIONS; i++) {
+    utilization[i] = results[i].total_busy_time/results[i].end_time;
+    mean_number[i] = results[i].integral_of_n/results[i].end_time;
+    mean_delay[i] = results[i].integral_of_n/results[i].customers_served;
+
+    printf("Replication %d: Utilization = %f, Mean number in system = %f, "
+	   "Mean delay = %f\n", i, utilization[i], mean_number[i],
+	   mean_delay[i]);
+  }
+
+  printf("\n");
+  output_replication_statistic("Utilization", utilization);
+  output_replication_statistic("Mean number in system", mean_number);
+  output_replication_statistic("Mean delay", mean_delay);
+}
+
 /*******************************************************************************/
 
 /*
@@ -48,17 +123,22 @@
  * is a customer arrival or customer departure. In either case the state of the
  * system is updated and statistics are collected before the next
  * iteration. When it finally reaches NUMBER_TO_SERVE customers, the program
- * outputs some statistics such as mean delay.
+ * outputs some statistics such as mean delay. If USE_LINDLEY_RECURSION is set,
+ * the loop is replaced by lindley_run, which gives the same results much
+ * faster.
  */
 
 int main()
 {
   double clock = 0; /* Clock keeps track of simulation time. */
 
+#if !USE_LINDLEY_RECURSION
   /* System state variables. */
   int number_in_system = 0;
   double next_arrival_time = 0;
   double next_departure_time = 0;
+  double last_event_time = 0;
+#endif
 
   /* Data collection variables. */
   long int total_served = 0;
@@ -66,11 +146,44 @@ int main()
 
   double total_busy_time = 0;
   double integral_of_n = 0;
-  double last_event_time = 0;
 
-  /* Set the seed of the random number generator. */
-  random_generator_initialize(RANDOM_SEED);
+  /* The random number stream used by this simulation. */
+  Rand_Stream rand_stream;
+
+  if (USE_REPLICATIONS) {
+    run_replications();
 
+    printf("Hit Enter to finish ... \n");
+    getchar();
+    return 0;
+  }
+
+  /* Set the seed of the random number generator. */
+  rand_stream_initialize(&rand_stream, RANDOM_SEED);
+
+#if USE_LINDLEY_RECURSION
+  {
+    Sampler interarrival, service;
+    Lindley_Results results;
+
+    sampler_exponential(&interarrival, &rand_stream, (double) 1/ARRIVAL_RATE);
+    sampler_constant(&service, SERVICE_TIME);
+
+    if (USE_TIME_PARALLEL_SCAN) {
+      lindley_run_parallel((long int) NUMBER_TO_SERVE, &interarrival, &service,
+			   NUMBER_OF_THREADS, &results);
+    } else {
+      lindley_run((long int) NUMBER_TO_SERVE, &interarrival, &service,
+		  &results);
+    }
+
+    clock = results.end_time;
+    total_served = results.customers_served;
+    total_arrived = results.customers_arrived;
+    total_busy_time = results.total_busy_time;
+    integral_of_n = results.integral_of_n;
+  }
+#else
   /* Process customers until we are finished. */
   while (total_served < NUMBER_TO_SERVE) {
 
@@ -82,7 +195,8 @@ int main()
       */
 
      clock = next_arrival_time;
-     next_arrival_time = clock + exponential_generator((double) 1/ARRIVAL_RATE);
+     next_arrival_time = clock +
+       rand_stream_exponential_generator(&rand_stream, (double) 1/ARRIVAL_RATE);
 
      /* Update our statistics. */
      integral_of_n += number_in_system * (clock - last_event_time);
@@ -128,6 +242,7 @@ int main()
    }
 
   }
+#endif
 
   /* Output final results. */
   printf("\nUtilization = %f\n", total_busy_time/clock);
@@ -0,0 +1,262 @@
+
+/*
+ *
+ * Simulation of Single Server Queueing System
+ *
+ * Copyright (C) 2014 Terence D. Todd Hamilton, Ontario, CANADA,
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*******************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include "lindley.h"
+
+/*******************************************************************************/
+
+/*
+ * Fill a block with exponentially distributed samples.
+ */
+
+static void
+fill_exponential(Sampler_Ptr sampler, double * block, long int size)
+{
+  rand_stream_exponential_block(sampler->rand_stream, sampler->mean, block,
+				size);
+}
+
+/*
+ * Fill a block with a constant, e.g., a deterministic service time.
+ */
+
+static void
+fill_constant(Sampler_Ptr sampler, double * block, long int size)
+{
+  long int i;
+
+  for (i=0; i<size; i++) block[i] = sampler->mean;
+}
+
+/*
+ * Set up a Sampler for exponential samples with the given mean, drawn from
+ * rand_stream.
+ */
+
+void
+sampler_exponential(Sampler_Ptr sampler, Rand_Stream_Ptr rand_stream,
+		    double mean)
+{
+  sampler->fill = fill_exponential;
+  sampler->rand_stream = rand_stream;
+  sampler->mean = mean;
+}
+
+/*
+ * Set up a Sampler which always gives value.
+ */
+
+void
+sampler_constant(Sampler_Ptr sampler, double value)
+{
+  sampler->fill = fill_constant;
+  sampler->rand_stream = NULL;
+  sampler->mean = value;
+}
+
+/*******************************************************************************/
+
+/*
+ * Count the customers that arrived before the last departure but were not
+ * served, continuing the arrivals from arrival_time, and add the time each of
+ * them spent in the system to *time_in_system.
+ */
+
+static long int
+count_unserved(Sampler_Ptr interarrival, double arrival_time,
+	       double departure_time, double * time_in_system)
+{
+  double interarrival_time;
+  long int count = 0;
+
+  while (arrival_time < departure_time) {
+    interarrival->fill(interarrival, &interarrival_time, 1);
+    *time_in_system += departure_time - arrival_time;
+    arrival_time += interarrival_time;
+    count++;
+  }
+  return count;
+}
+
+/*
+ * Run a G/G/1 queue until number_to_serve customers have departed.
+ *
+ * The area under the number in system curve up to the end time is the sum of
+ * the times in system of the customers served, plus, for each customer that
+ * arrived before the end but is still in the system, the time from its arrival
+ * to the end. The second part is found by continuing the arrivals (without
+ * their service) until one falls at or after the end time.
+ */
+
+void
+lindley_run(long int number_to_serve, Sampler_Ptr interarrival,
+	    Sampler_Ptr service, Lindley_Results_Ptr results)
+{
+  double interarrival_times[LINDLEY_BLOCK_SIZE];
+  double service_times[LINDLEY_BLOCK_SIZE];
+  double arrival_time = 0.0;
+  double departure_time = 0.0;
+  double busy_time = 0.0;
+  double time_in_system = 0.0;
+  long int served = 0;
+  long int arrived = 0;
+  long int block_size;
+  long int i;
+
+  /* Customers that are served. */
+  while (served < number_to_serve) {
+    block_size = number_to_serve - served;
+    if (block_size > LINDLEY_BLOCK_SIZE) block_size = LINDLEY_BLOCK_SIZE;
+
+    interarrival->fill(interarrival, interarrival_times, block_size);
+    service->fill(service, service_times, block_size);
+
+    for (i=0; i<block_size; i++) {
+      if (arrival_time > departure_time) departure_time = arrival_time;
+      departure_time += service_times[i];
+
+      busy_time += service_times[i];
+      time_in_system += departure_time - arrival_time;
+
+      arrival_time += interarrival_times[i];
+    }
+
+    served += block_size;
+  }
+  arrived = served + count_unserved(interarrival, arrival_time,
+				    departure_time, &time_in_system);
+
+  results->customers_served = served;
+  results->customers_arrived = arrived;
+  results->end_time = departure_time;
+  results->total_busy_time = busy_time;
+  results->integral_of_n = time_in_system;
+}
+
+/*******************************************************************************/
+
+/*
+ * The same run as lindley_run, with the departure times found by
+ * maxplus_departures on number_of_threads threads (see simlib.h). The samples
+ * are drawn in the same blocks and the sums are taken in the same order as in
+ * lindley_run, so the results are identical to it.
+ */
+
+void
+lindley_run_parallel(long int number_to_serve, Sampler_Ptr interarrival,
+		     Sampler_Ptr service, int number_of_threads,
+		     Lindley_Results_Ptr results)
+{
+  double * arrival_times;
+  double * service_times;
+  double * departure_times;
+  double arrival_time = 0.0;
+  double departure_time = 0.0;
+  double busy_time = 0.0;
+  double time_in_system = 0.0;
+  long int served = 0;
+  long int segment_size;
+  long int block_size;
+  long int i;
+
+  arrival_times = (double *) xmalloc(LINDLEY_SEGMENT_SIZE * sizeof(double));
+  service_times = (double *) xmalloc(LINDLEY_SEGMENT_SIZE * sizeof(double));
+  departure_times = (double *) xmalloc(LINDLEY_SEGMENT_SIZE * sizeof(double));
+
+  while (served < number_to_serve) {
+    segment_size = number_to_serve - served;
+    if (segment_size > LINDLEY_SEGMENT_SIZE) segment_size = LINDLEY_SEGMENT_SIZE;
+
+    /*
+     * Draw the segment block by block. The interarrival times are put in
+     * departure_times for now and then turned into arrival times.
+     */
+    for (i=0; i<segment_size; i+=block_size) {
+      block_size = segment_size - i;
+      if (block_size > LINDLEY_BLOCK_SIZE) block_size = LINDLEY_BLOCK_SIZE;
+
+      interarrival->fill(interarrival, departure_times + i, block_size);
+      service->fill(service, service_times + i, block_size);
+    }
+
+    for (i=0; i<segment_size; i++) {
+      arrival_times[i] = arrival_time;
+      arrival_time += departure_times[i];
+    }
+
+    departure_time = maxplus_departures(arrival_times, service_times,
+					departure_times, segment_size,
+					departure_time, number_of_threads);
+
+    for (i=0; i<segment_size; i++) {
+      busy_time += service_times[i];
+      time_in_system += departure_times[i] - arrival_times[i];
+    }
+
+    served += segment_size;
+  }
+
+  results->customers_served = served;
+  results->customers_arrived = served +
+    count_unserved(interarrival, arrival_time, departure_time, &time_in_system);
+  results->end_time = departure_time;
+  results->total_busy_time = busy_time;
+  results->integral_of_n = time_in_system;
+
+  xfree((void *) arrival_times);
+  xfree((void *) service_times);
+  xfree((void *) departure_times);
+}
+
+/*******************************************************************************/
+
+/*
+ * Run LINDLEY_REPLICATIONS replications of an M/D/1 queue, with mean
+ * interarrival time interarrival_mean and service time service_time, each
+ * until it has served number_to_serve customers. Replication k uses substream
+ * k of seed, and its results are put in results[k].
+ */
+
+void
+lindley_run_replications(long int number_to_serve, double interarrival_mean,
+			 double service_time, unsigned seed,
+			 Lindley_Results * results)
+{
+  Rand_Stream rand_stream;
+  Sampler interarrival, service;
+  int k;
+
+  for (k=0; k<LINDLEY_REPLICATIONS; k++) {
+    rand_stream_initialize(&rand_stream, seed);
+    rand_stream_jump(&rand_stream, (unsigned long) k);
+    sampler_exponential(&interarrival, &rand_stream, interarrival_mean);
+    sampler_constant(&service, service_time);
+
+    lindley_run(number_to_serve, &interarrival, &service, results + k);
+  }
+}
+
@@ -0,0 +1,122 @@
+
+/*
+ *
+ * Simulation of Single Server Queueing System
+ *
+ * Copyright (C) 2014 Terence D. Todd Hamilton, Ontario, CANADA,
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*******************************************************************************/
+
+#ifndef _LINDLEY_H_
+#define _LINDLEY_H_
+
+/*******************************************************************************/
+
+#include "simlib.h"
+
+/*******************************************************************************/
+
+/*
+ * A FIFO single server queue (G/G/1) needs no event list at all. Customer n
+ * arrives at A(n) and departs at
+ *
+ *   D(n) = max(A(n), D(n-1)) + S(n)
+ *
+ * which is the Lindley recursion written for departure times. The kernel
+ * draws interarrival and service times LINDLEY_BLOCK_SIZE at a time from two
+ * Samplers and then runs the recursion over the block in a tight loop.
+ *
+ * The first customer arrives at time 0, and the run ends at the departure of
+ * customer number_to_serve, exactly as in the event driven loop. Arrival and
+ * departure times are computed with the same floating point operations as
+ * the event loop, so with the same random stream it sees the same customers.
+ */
+
+#define LINDLEY_BLOCK_SIZE 4096
+
+/*
+ * lindley_run_parallel works through the run LINDLEY_SEGMENT_SIZE customers at
+ * a time, a multiple of LINDLEY_BLOCK_SIZE, so that a run of any length fits
+ * in memory.
+ */
+
+#define LINDLEY_SEGMENT_SIZE (256 * LINDLEY_BLOCK_SIZE)
+
+/*
+ * A Sampler fills a block with samples of one distribution.
+ */
+
+typedef struct _sampler_
+{
+  void (* fill)(struct _sampler_ *, double *, long int);
+  Rand_Stream_Ptr rand_stream;
+  double mean;
+} Sampler, * Sampler_Ptr;
+
+/*
+ * The results of a run. The mean number in system is integral_of_n/end_time,
+ * and the mean delay is integral_of_n/customers_served.
+ */
+
+typedef struct _lindley_results_
+{
+  long int customers_served;
+  long int customers_arrived;
+  double end_time;
+  double total_busy_time;
+  double integral_of_n;
+} Lindley_Results, * Lindley_Results_Ptr;
+
+/*
+ * Independent replications. lindley_run_replications runs
+ * LINDLEY_REPLICATIONS replications of an M/D/1 queue one after the other,
+ * replication k on substream k of the seed (see rand_stream_jump), so the
+ * results of each are exactly those of lindley_run with that substream. The
+ * spread of the results across replications gives confidence intervals.
+ */
+
+#define LINDLEY_REPLICATIONS 8
+
+/*******************************************************************************/
+
+/*
+ * Function prototypes
+ */
+
+void
+sampler_exponential(Sampler_Ptr, Rand_Stream_Ptr, double);
+
+void
+sampler_constant(Sampler_Ptr, double);
+
+void
+lindley_run(long int, Sampler_Ptr, Sampler_Ptr, Lindley_Results_Ptr);
+
+void
+lindley_run_parallel(long int, Sampler_Ptr, Sampler_Ptr, int,
+		     Lindley_Results_Ptr);
+
+void
+lindley_run_replications(long int, double, double, unsigned,
+			 Lindley_Results *);
+
+/*******************************************************************************/
+
+#endif /* lindley.h */
+
@@ -0,0 +1,168 @@
+
+/*
+ *
+ * Simlib Event List Benchmark
+ *
+ * Copyright (C) 2014 Terence D. Todd Hamilton, Ontario, CANADA,
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/******************************************************************************/
+
+/*
+ * This program compares the event list types available in simlib using the
+ * "hold" model. The event list is first loaded with a given number of pending
+ * events. Each event, when it is executed, schedules one replacement event an
+ * exponentially distributed time later so that the number of pending events
+ * stays constant. The mean time taken by each hold (one event executed and
+ * one scheduled) is printed for increasing numbers of pending events.
+ *
+ * Since the hold times are exponential, the pending events in steady state
+ * occur at independent exponentially distributed times from now. The event
+ * list is loaded with such times in increasing order, so that loading the
+ * linked list does not itself take O(n^2) time.
+ *
+ * To build it (from this directory):
+ *
+ *   gcc -O2 -pthread -I.. -o eventlist_benchmark eventlist_benchmark.c ../simlib.c -lm
+ */
+
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "simlib.h"
+
+/******************************************************************************/
+
+#define PENDING_EVENT_COUNTS 10, 100, 1000, 10000, 100000, 1000000
+#define HOLDS_PER_RUN 1e6
+#define MAX_LINKED_WORK 2e7 /* Caps holds x pending events for the list. */
+#define MEAN_HOLD_TIME 1.0
+#define RANDOM_SEED 400167784
+
+/******************************************************************************/
+
+static Rand_Stream_Ptr hold_stream;
+
+/*
+ * The hold event reschedules itself.
+ */
+
+static void hold_event(Simulation_Run_Ptr, void *);
+
+static void
+schedule_hold_event(Simulation_Run_Ptr simulation_run, double event_time)
+{
+  Event event;
+
+  event.description = "Hold";
+  event.function = hold_event;
+  event.attachment = NULL;
+
+  simulation_run_schedule_event(simulation_run, event, event_time);
+}
+
+static void
+hold_event(Simulation_Run_Ptr simulation_run, void * ptr)
+{
+  schedule_hold_event(simulation_run, simulation_run_get_time(simulation_run) +
+	rand_stream_exponential_generator(hold_stream, MEAN_HOLD_TIME));
+}
+
+static int
+compare_times(const void * a, const void * b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+  return (x > y) - (x < y);
+}
+
+/*
+ * Load an event list of the given type with pending_events events, then time
+ * number_of_holds hold operations. The mean time per hold is returned in
+ * nanoseconds.
+ */
+
+static double
+time_holds(Eventlist_Type eventlist_type, long int pending_events,
+	   long int number_of_holds)
+{
+  Simulation_Run_Ptr simulation_run;
+  double * initial_times;
+  clock_t start;
+  double elapsed;
+  long int i;
+
+  rand_stream_initialize(hold_stream, RANDOM_SEED);
+  simulation_run = simulation_run_new_with_eventlist(eventlist_type);
+
+  initial_times = (double *) xcalloc((unsigned) pending_events, sizeof(double));
+  for (i=0; i<pending_events; i++) {
+    initial_times[i] =
+      rand_stream_exponential_generator(hold_stream, MEAN_HOLD_TIME);
+  }
+  qsort(initial_times, pending_events, sizeof(double), compare_times);
+  for (i=0; i<pending_events; i++) {
+    schedule_hold_event(simulation_run, initial_times[i]);
+  }
+  xfree(initial_times);
+
+  start = clock();
+  for (i=0; i<number_of_holds; i++) {
+    simulation_run_execute_event(simulation_run);
+  }
+  elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+  simulation_run_free_memory(simulation_run);
+  return 1e9 * elapsed / number_of_holds;
+}
+
+int
+main(void)
+{
+  long int PENDING_EVENTS[] = {PENDING_EVENT_COUNTS, 0};
+  long int pending_events, linked_holds;
+  double linked_time, heap_time, calendar_time;
+  int i = 0;
+
+  hold_stream = rand_stream_new(RANDOM_SEED);
+
+  printf("Mean time per hold operation (nsec)\n\n");
+  printf("%10s %12s %12s %12s\n", "pending", "linked", "heap", "calendar");
+
+  while ((pending_events = PENDING_EVENTS[i++]) != 0) {
+
+    /* The linked list is O(n) per hold, so do fewer of them when it is long. */
+    linked_holds = (long int) HOLDS_PER_RUN;
+    if ((double) linked_holds * pending_events > MAX_LINKED_WORK)
+      linked_holds = (long int) (MAX_LINKED_WORK / pending_events);
+
+    /* Timed one at a time so that they draw from the stream in order. */
+    linked_time = time_holds(LINKED_EVENTLIST, pending_events, linked_holds);
+    heap_time = time_holds(HEAP_EVENTLIST, pending_events,
+			   (long int) HOLDS_PER_RUN);
+    calendar_time = time_holds(CALENDAR_EVENTLIST, pending_events,
+			       (long int) HOLDS_PER_RUN);
+
+    printf("%10ld %12.1f %12.1f %12.1f\n", pending_events,
+	   linked_time, heap_time, calendar_time);
+    fflush(stdout);
+  }
+
+  return 0;
+}
@@ -38,46 +38,16 @@ void
 cleanup_memory (Simulation_Run_Ptr simulation_run)
 {
   Simulation_Run_Data_Ptr data;
-  Fifoqueue_Ptr buffer;
-  Fifoqueue_Ptr buffer2;
-  Fifoqueue_Ptr buffer3;
-  Server_Ptr link1;
-  Server_Ptr link2;
-  Server_Ptr link3;
 
   data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
 
-  buffer = data->buffer;
-  buffer2 = data->buffer2;
-  buffer3 = data->buffer2;
+  /*
+   * The packets, whether in a buffer, on a link or attached to an event, come
+   * from the run pool and are released along with the simulation_run, so only
+   * the network, which holds the links and buffers, needs to be freed here.
+   */
 
-  link1 = data->link;
-  link2 = data->link2;
-  link2 = data->link3;
-
-  if(link1->state == BUSY) /* Clean out the first server. */
-    xfree(server_get(link1));
-  xfree(link1);
-
-  if(link2->state == BUSY) /* Clean out the second server. */
-    xfree(server_get(link2));
-  xfree(link2);
-
-  if(link3->state == BUSY) /* Clean out the third server. */
-    xfree(server_get(link3));
-  xfree(link3);
-
-  while (fifoqueue_size(buffer) > 0) /* Clean out the sw1 queue. */
-    xfree(fifoqueue_get(buffer));
-  xfree(buffer);
-
-  while (fifoqueue_size(buffer2) > 0) /* Clean out the sw2 queue. */
-    xfree(fifoqueue_get(buffer2));
-  xfree(buffer2);
-
-  while (fifoqueue_size(buffer3) > 0) /* Clean out the sw3 queue. */
-    xfree(fifoqueue_get(buffer3));
-  xfree(buffer3);
+  network_free(data->network);
 
   simulation_run_free_memory(simulation_run); /* Clean up the simulation_run. */
 }
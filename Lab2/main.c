@@ -37,11 +37,16 @@
 
 /*
  * main.c declares and creates a new simulation_run with parameters defined in
- * simparameters.h. The code creates a fifo queue and server for the single
- * server queueuing system. It then loops through the list of random number
- * generator seeds defined in simparameters.h, doing a separate simulation_run
- * run for each. To start a run, it schedules the first packet arrival
- * event. When each run is finished, output is printed on the terminal.
+ * simparameters.h. The network of switches is read from NETWORK_FILE (see
+ * network.h). It then loops through the list of random number generator seeds
+ * defined in simparameters.h, doing a separate simulation_run run for each. To
+ * start a run, it schedules the first packet arrival event at each switch
+ * that has outside arrivals. When each run is finished, output is printed on
+ * the terminal.
+ *
+ * The network is solved analytically first (network_solve). If a switch is
+ * unstable nothing is simulated, and if the delays of a run agree with the
+ * analytic ones to within AGREEMENT_TOLERANCE the remaining seeds are skipped.
  */
 
 int
@@ -49,6 +54,7 @@ main(void)
 {
   Simulation_Run_Ptr simulation_run;
   Simulation_Run_Data data;
+  Switch_Ptr this_switch;
 
   /*
    * Declare and initialize our random number generator seeds defined in
@@ -58,109 +64,90 @@ main(void)
   unsigned RANDOM_SEEDS[] = {RANDOM_SEED_LIST, 0};
   unsigned random_seed;
 
-  int ARRIVAL_RATES[] = {PACKET_ARRIVAL_RATE_LIST, 0};
-  int arrival_rate;
-
-  int j=0;
+  int i, j=0;
+  int delays_agree;
 
   /*
    * Loop for each random number generator seed, doing a separate
    * simulation_run run for each.
    */
 
-    while ((random_seed = RANDOM_SEEDS[j++]) != 0) {
-        int i=0;
-        while((arrival_rate = ARRIVAL_RATES[i++]) != 0){
-            simulation_run = simulation_run_new(); /* Create a new simulation run. */
-
-            /*
-            * Set the simulation_run data pointer to our data object.
-            */
-
-            simulation_run_attach_data(simulation_run, (void *) & data);
-
-            /*
-            * Initialize the simulation_run data variables, declared in main.h.
-            */
+  while ((random_seed = RANDOM_SEEDS[j++]) != 0) {
 
-            data.blip_counter = 0;
+    simulation_run = simulation_run_new(); /* Create a new simulation run. */
 
-            // Use this to track arrivals at each switch
-            data.arrival_count = 0;
-            data.arrival_count2 = 0;
-            data.arrival_count3 = 0;
+    /*
+     * Set the simulation_run data pointer to our data object.
+     */
 
-            // Use this to ensure enough packets are processed at each switch
-            data.number_of_packets_processed = 0;
-            data.number_of_packets_processed2 = 0;
-            data.number_of_packets_processed3 = 0;
+    simulation_run_attach_data(simulation_run, (void *) & data);
 
-            data.accumulated_delay = 0.0;   // Packets originating from switch 1
-            data.accumulated_delay2 = 0.0;  // Packets originating from switch 2
-            data.accumulated_delay3 = 0.0;  // Packets originating from switch 3
+    /*
+     * Initialize the simulation_run data variables, declared in main.h. The
+     * switches, with their buffers, links and statistics, come from the
+     * network file.
+     */
 
-            data.random_seed = random_seed;
+    data.blip_counter = 0;
+    data.random_seed = random_seed;
+    data.network = network_new(NETWORK_FILE, PACKET_LENGTH, DRIFT_BATCH_SIZE);
+    data.unstable_switch = NULL;
+    data.packet_pool = simulation_run_pool_new(simulation_run, sizeof(Packet));
 
-            data.arrival_rate = 750;        // lambda 1
-            data.arrival_rate_23 = 500;     // lambda 2
+    if(network_solve(data.network) > 0 && SKIP_UNSTABLE_NETWORKS) {
+      output_analytic_results(data.network);
+      cleanup_memory(simulation_run);
+      break;
+    }
 
-            /*
-            * Create the packet buffer and transmission link, declared in main.h.
-            */
+    /*
+     * Set the random number generator seed for this run.
+     */
 
-            data.buffer = fifoqueue_new();
-            data.buffer2 = fifoqueue_new();
-            data.buffer3 = fifoqueue_new();
-            data.link   = server_new();
-            data.link2   = server_new();
-            data.link3   = server_new();
+    simulation_run_random_generator_initialize(simulation_run, random_seed);
 
-            /*
-            * Set the random number generator seed for this run.
-            */
+    /*
+     * Schedule the initial packet arrival at each switch for the current
+     * clock time (= 0).
+     */
 
-            random_generator_initialize(random_seed);
+    for(i=0; i<data.network->number_of_switches; i++) {
+      this_switch = data.network->switches + i;
+      if(this_switch->arrival_rate > 0) {
+        schedule_packet_arrival_event(simulation_run,
+                                      simulation_run_get_time(simulation_run),
+                                      this_switch);
+      }
+    }
 
-            /*
-            * Schedule the initial packet arrival for the current clock time (= 0).
-            */
+    /*
+     * Execute events until every switch has sent RUNLENGTH packets, or a
+     * switch is found to be unstable.
+     */
 
-            schedule_packet_arrival_event(simulation_run, simulation_run_get_time(simulation_run));
-            schedule_packet_arrival_event_2(simulation_run, simulation_run_get_time(simulation_run));
-            schedule_packet_arrival_event_3(simulation_run, simulation_run_get_time(simulation_run));
+    while(!network_finished(data.network, (long int) RUNLENGTH) &&
+          data.unstable_switch == NULL) {
+      simulation_run_execute_event(simulation_run);
+    }
 
-            /*
-            * Execute events until we are finished.
-            */
+    /*
+     * Output results and clean up after ourselves.
+     */
 
-            while(data.number_of_packets_processed < RUNLENGTH ||
-                  data.number_of_packets_processed2 < RUNLENGTH ||
-                  data.number_of_packets_processed3 < RUNLENGTH)
-            {
-                simulation_run_execute_event(simulation_run);
-            }
+    output_results(simulation_run);
 
-            /*
-            * Output results and clean up after ourselves.
-            */
+    delays_agree = AGREEMENT_TOLERANCE > 0 && data.unstable_switch == NULL &&
+      network_delays_agree(data.network, AGREEMENT_TOLERANCE);
+    cleanup_memory(simulation_run);
 
-            output_results(simulation_run);
-            cleanup_memory(simulation_run);
-        }
+    if(delays_agree) {
+      printf("The delays agree with the analytic ones to within %g%%, so no more seeds are run.\n",
+             100.0 * AGREEMENT_TOLERANCE);
+      break;
     }
+  }
 
   getchar();   /* Pause before finishing. */
   return 0;
 }
 
-
-
-
-
-
-
-
-
-
-
-
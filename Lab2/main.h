@@ -30,36 +30,24 @@
 
 #include "simlib.h"
 #include "simparameters.h"
+#include "network.h"
 
 /******************************************************************************/
 
 typedef struct _simulation_run_data_
 {
-  Fifoqueue_Ptr buffer;
-  Fifoqueue_Ptr buffer2;
-  Fifoqueue_Ptr buffer3;
-  Server_Ptr link;
-  Server_Ptr link2;
-  Server_Ptr link3;
+  Network_Ptr network;
+  Switch_Ptr unstable_switch;
+  Pool_Ptr packet_pool;
   long int blip_counter;
-  long int arrival_count;
-  long int arrival_count2;
-  long int arrival_count3;
-  long int number_of_packets_processed;
-  long int number_of_packets_processed2;
-  long int number_of_packets_processed3;
-  double accumulated_delay;
-  double accumulated_delay2;
-  double accumulated_delay3;
   unsigned random_seed;
-  int arrival_rate;
-  int arrival_rate_23;
 } Simulation_Run_Data, * Simulation_Run_Data_Ptr;
 
 typedef enum {XMTTING, WAITING} Packet_Status;
 
 typedef struct _packet_
 {
+  Queue_Link queue_link;
   double arrive_time;
   double service_time;
   int source_id;
@@ -0,0 +1,548 @@
+
+/*
+ *
+ * Simulation_Run of A Single Server Queueing System
+ *
+ * Copyright (C) 2014 Terence D. Todd Hamilton, Ontario, CANADA,
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "network.h"
+
+/******************************************************************************/
+
+/*
+ * A route as read from the file, before the routes are grouped by the switch
+ * they leave.
+ */
+
+typedef struct _route_line_
+{
+  int from_switch;
+  int to_switch;
+  double probability;
+} Route_Line, * Route_Line_Ptr;
+
+/*
+ * Print a configuration error and quit.
+ */
+
+static void
+network_error(const char * file_name, int line_number, const char * message)
+{
+  printf("Error: %s line %d: %s\n", file_name, line_number, message);
+  exit(1);
+}
+
+/*
+ * Mark the switches that see any traffic, i.e., those with outside arrivals
+ * and those that can be reached from them along routes with a nonzero
+ * probability. The run only waits for these switches.
+ */
+
+static void
+network_mark_traffic(Network_Ptr network)
+{
+  int * stack;
+  int top = 0;
+  int i;
+  long int r;
+  Switch_Ptr this_switch;
+
+  stack = (int *) xcalloc(network->number_of_switches, sizeof(int));
+
+  for (i=0; i<network->number_of_switches; i++) {
+    if (network->switches[i].arrival_rate > 0) {
+      network->switches[i].carries_traffic = 1;
+      stack[top++] = i;
+    }
+  }
+
+  while (top > 0) {
+    this_switch = network->switches + stack[--top];
+    for (r=this_switch->first_route;
+	 r<this_switch->first_route + this_switch->number_of_routes; r++) {
+      if (network->routes[r].cumulative_probability <=
+	  (r > this_switch->first_route ?
+	   network->routes[r-1].cumulative_probability : 0.0))
+	continue;
+
+      i = network->routes[r].next_switch;
+      if (!network->switches[i].carries_traffic) {
+	network->switches[i].carries_traffic = 1;
+	stack[top++] = i;
+      }
+    }
+  }
+
+  xfree(stack);
+}
+
+/*
+ * Read the network in file_name. Each switch sends packets of packet_length
+ * bits, and its Drift_Detector starts with batches of drift_batch_size
+ * arrivals. The switches start out idle, with empty buffers and no
+ * statistics.
+ */
+
+Network_Ptr
+network_new(const char * file_name, double packet_length,
+	    long int drift_batch_size)
+{
+  FILE * file;
+  char line[NETWORK_MAX_LINE];
+  char keyword[NETWORK_MAX_LINE];
+  char * comment;
+  Network_Ptr network;
+  Switch_Ptr this_switch;
+  Route_Line_Ptr route_lines = NULL;
+  long int route_line_capacity = 0;
+  long int * next_route;
+  double * total_probability;
+  int line_number = 0;
+  int switch_capacity = 0;
+  int number, from, to;
+  double rate, bit_rate, probability;
+  double min_threshold, max_threshold, max_probability, weight;
+  long int capacity;
+  long int r;
+  int i;
+
+  if ((file = fopen(file_name, "r")) == NULL) {
+    printf("Error: Could not open network file %s.\n", file_name);
+    exit(1);
+  }
+
+  network = (Network_Ptr) xcalloc(1, sizeof(Network));
+
+  while (fgets(line, NETWORK_MAX_LINE, file) != NULL) {
+    line_number++;
+    if ((comment = strchr(line, '#')) != NULL) *comment = '\0';
+    if (sscanf(line, "%s", keyword) != 1) continue;
+
+    if (strcmp(keyword, "switch") == 0) {
+      if (sscanf(line, "%*s %d %lf %lf", &number, &rate, &bit_rate) != 3)
+	network_error(file_name, line_number,
+		      "expected switch <number> <arrival rate> <bit rate>");
+      if (number != network->number_of_switches + 1)
+	network_error(file_name, line_number,
+		      "switches must be numbered 1, 2, ... in order");
+      if (rate < 0 || bit_rate <= 0)
+	network_error(file_name, line_number, "bad arrival rate or bit rate");
+
+      if (network->number_of_switches == switch_capacity) {
+	switch_capacity = switch_capacity ? 2 * switch_capacity : 16;
+	network->switches = (Switch_Ptr)
+	  xrealloc(network->switches, switch_capacity * sizeof(Switch));
+      }
+
+      /* An all zero Linkqueue and Server are empty and FREE. */
+      this_switch = network->switches + network->number_of_switches++;
+      memset(this_switch, 0, sizeof(Switch));
+      this_switch->id = number;
+      this_switch->arrival_rate = rate;
+      this_switch->link_bit_rate = bit_rate;
+      this_switch->service_time = packet_length / bit_rate;
+      this_switch->queue_drift = drift_detector_new(drift_batch_size);
+      this_switch->warmup = warmup_detector_new();
+
+    } else if (strcmp(keyword, "buffer") == 0) {
+      if (sscanf(line, "%*s %d %ld", &number, &capacity) != 2)
+	network_error(file_name, line_number,
+		      "expected buffer <switch> <packets>");
+      if (number < 1 || number > network->number_of_switches)
+	network_error(file_name, line_number,
+		      "unknown switch (switches must come first)");
+      if (capacity < 1)
+	network_error(file_name, line_number, "bad buffer size");
+
+      network->switches[number-1].buffer_capacity = capacity;
+
+    } else if (strcmp(keyword, "red") == 0) {
+      if (sscanf(line, "%*s %d %lf %lf %lf %lf", &number, &min_threshold,
+		 &max_threshold, &max_probability, &weight) != 5)
+	network_error(file_name, line_number,
+		      "expected red <switch> <min threshold> <max threshold> <max probability> <weight>");
+      if (number < 1 || number > network->number_of_switches)
+	network_error(file_name, line_number,
+		      "unknown switch (switches must come first)");
+      if (min_threshold < 0 || max_threshold <= min_threshold ||
+	  max_probability <= 0 || max_probability > 1 ||
+	  weight <= 0 || weight > 1)
+	network_error(file_name, line_number, "bad RED parameters");
+
+      this_switch = network->switches + number - 1;
+      this_switch->use_red = 1;
+      this_switch->red_min_threshold = min_threshold;
+      this_switch->red_max_threshold = max_threshold;
+      this_switch->red_max_probability = max_probability;
+      this_switch->red_weight = weight;
+
+    } else if (strcmp(keyword, "route") == 0) {
+      if (sscanf(line, "%*s %d %d %lf", &from, &to, &probability) != 3)
+	network_error(file_name, line_number,
+		      "expected route <from switch> <to switch> <probability>");
+      if (probability < 0 || probability > 1)
+	network_error(file_name, line_number, "bad route probability");
+
+      if (network->number_of_routes == route_line_capacity) {
+	route_line_capacity = route_line_capacity ? 2 * route_line_capacity : 16;
+	route_lines = (Route_Line_Ptr)
+	  xrealloc(route_lines, route_line_capacity * sizeof(Route_Line));
+      }
+      route_lines[network->number_of_routes].from_switch = from;
+      route_lines[network->number_of_routes].to_switch = to;
+      route_lines[network->number_of_routes].probability = probability;
+      network->number_of_routes++;
+
+    } else {
+      network_error(file_name, line_number, "unknown keyword");
+    }
+  }
+  fclose(file);
+
+  if (network->number_of_switches == 0) {
+    printf("Error: No switches in network file %s.\n", file_name);
+    exit(1);
+  }
+
+  /* Group the routes by the switch they leave, keeping their order. */
+  for (r=0; r<network->number_of_routes; r++) {
+    from = route_lines[r].from_switch;
+    to = route_lines[r].to_switch;
+    if (from < 1 || from > network->number_of_switches ||
+	to < 1 || to > network->number_of_switches) {
+      printf("Error: Route from switch %d to switch %d in %s names an unknown switch.\n",
+	     from, to, file_name);
+      exit(1);
+    }
+    network->switches[from-1].number_of_routes++;
+  }
+
+  for (i=1; i<network->number_of_switches; i++) {
+    network->switches[i].first_route = network->switches[i-1].first_route +
+      network->switches[i-1].number_of_routes;
+  }
+
+  network->routes = (Route_Ptr)
+    xcalloc(network->number_of_routes ? network->number_of_routes : 1,
+	    sizeof(Route));
+  next_route = (long int *)
+    xcalloc(network->number_of_switches, sizeof(long int));
+  total_probability = (double *)
+    xcalloc(network->number_of_switches, sizeof(double));
+
+  for (i=0; i<network->number_of_switches; i++)
+    next_route[i] = network->switches[i].first_route;
+
+  for (r=0; r<network->number_of_routes; r++) {
+    i = route_lines[r].from_switch - 1;
+    total_probability[i] += route_lines[r].probability;
+    if (total_probability[i] > 1 + 1e-9) {
+      printf("Error: Routes leaving switch %d in %s add up to more than 1.\n",
+	     i+1, file_name);
+      exit(1);
+    }
+    network->routes[next_route[i]].next_switch = route_lines[r].to_switch - 1;
+    network->routes[next_route[i]].cumulative_probability =
+      total_probability[i];
+    next_route[i]++;
+  }
+
+  if (route_lines != NULL) xfree(route_lines);
+  xfree(next_route);
+  xfree(total_probability);
+
+  network_mark_traffic(network);
+  return network;
+}
+
+/*
+ * Decide whether a packet arriving at this_switch is kept. A packet that finds
+ * the link free is always kept. One that would have to wait is dropped if the
+ * buffer is full, or, with RED, with a probability that depends on the average
+ * buffer length. The RED average is updated at every arrival, and a random
+ * number is only drawn when the average is between the two thresholds. The
+ * drop counts of the switch are updated here.
+ */
+
+int
+network_switch_accepts(Switch_Ptr this_switch,
+		       Simulation_Run_Ptr simulation_run)
+{
+  long int queue_length;
+  double drop_probability;
+
+  queue_length = linkqueue_size(&this_switch->buffer);
+
+  if (this_switch->use_red) {
+    this_switch->red_average += this_switch->red_weight *
+      (queue_length - this_switch->red_average);
+  }
+
+  if (server_state(&this_switch->link) == FREE) return 1;
+
+  if (this_switch->buffer_capacity > 0 &&
+      queue_length >= this_switch->buffer_capacity) {
+    this_switch->tail_drop_count++;
+    return 0;
+  }
+
+  if (this_switch->use_red) {
+    if (this_switch->red_average < this_switch->red_min_threshold) {
+      this_switch->red_count = 0;
+      return 1;
+    }
+
+    if (this_switch->red_average >= this_switch->red_max_threshold) {
+      this_switch->red_count = 0;
+      this_switch->red_drop_count++;
+      return 0;
+    }
+
+    /*
+     * Spread the drops out evenly by raising the probability with the number
+     * of packets kept since the last drop.
+     */
+    drop_probability = this_switch->red_max_probability *
+      (this_switch->red_average - this_switch->red_min_threshold) /
+      (this_switch->red_max_threshold - this_switch->red_min_threshold);
+    this_switch->red_count++;
+    if (this_switch->red_count * drop_probability < 1)
+      drop_probability /= 1 - this_switch->red_count * drop_probability;
+    else
+      drop_probability = 1;
+
+    if (simulation_run_uniform_generator(simulation_run) < drop_probability) {
+      this_switch->red_count = 0;
+      this_switch->red_drop_count++;
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/*
+ * Pick the switch that a packet which has just been sent on this_switch's link
+ * goes to next. NULL is returned if the packet leaves the network. A random
+ * number is only drawn if the switch has routes.
+ */
+
+Switch_Ptr
+network_next_switch(Network_Ptr network, Switch_Ptr this_switch,
+		    Simulation_Run_Ptr simulation_run)
+{
+  Route_Ptr route, last_route;
+  double u;
+
+  if (this_switch->number_of_routes == 0) return NULL;
+
+  u = simulation_run_uniform_generator(simulation_run);
+  route = network->routes + this_switch->first_route;
+  last_route = route + this_switch->number_of_routes;
+
+  for (; route<last_route; route++) {
+    if (u <= route->cumulative_probability)
+      return network->switches + route->next_switch;
+  }
+  return NULL;
+}
+
+/*
+ * Return 1 once every switch that carries traffic has sent at least
+ * number_of_packets packets.
+ */
+
+int
+network_finished(Network_Ptr network, long int number_of_packets)
+{
+  int i;
+
+  for (i=0; i<network->number_of_switches; i++) {
+    if (network->switches[i].carries_traffic &&
+	network->switches[i].number_of_packets_processed < number_of_packets)
+      return 0;
+  }
+  return 1;
+}
+
+/*
+ * Solve value = constant + routes applied to value by iteration, where the
+ * routes move traffic forward (value_j = constant_j + sum of value_i p_ij) or
+ * collect delays backward (value_i = constant_i + sum of p_ij value_j). It
+ * ends once no value changes by more than NETWORK_SOLVE_PRECISION relative to
+ * itself. A feed-forward network takes one iteration per switch on its
+ * longest path. Values that are still changing after
+ * NETWORK_SOLVE_MAX_ITERATIONS, because packets can loop forever, are set to
+ * HUGE_VAL.
+ */
+
+static void
+network_solve_routes(Network_Ptr network, const double * constant,
+		     double * value, int forward)
+{
+  double * next_value;
+  double probability, change;
+  long int iteration, r;
+  int i, j, changed = 1;
+  Switch_Ptr this_switch;
+
+  next_value = (double *) xcalloc(network->number_of_switches, sizeof(double));
+
+  for (i=0; i<network->number_of_switches; i++) value[i] = constant[i];
+
+  for (iteration=0; changed && iteration<NETWORK_SOLVE_MAX_ITERATIONS;
+       iteration++) {
+    for (i=0; i<network->number_of_switches; i++) next_value[i] = constant[i];
+
+    for (i=0; i<network->number_of_switches; i++) {
+      this_switch = network->switches + i;
+      for (r=this_switch->first_route;
+	   r<this_switch->first_route + this_switch->number_of_routes; r++) {
+	probability = network->routes[r].cumulative_probability -
+	  (r > this_switch->first_route ?
+	   network->routes[r-1].cumulative_probability : 0.0);
+	if (probability <= 0.0) continue;
+
+	j = network->routes[r].next_switch;
+	if (forward) next_value[j] += value[i] * probability;
+	else next_value[i] += probability * value[j];
+      }
+    }
+
+    changed = 0;
+    for (i=0; i<network->number_of_switches; i++) {
+      change = fabs(next_value[i] - value[i]);
+      if (change > NETWORK_SOLVE_PRECISION * fabs(next_value[i])) {
+	changed = 1;
+	if (iteration == NETWORK_SOLVE_MAX_ITERATIONS - 1)
+	  next_value[i] = HUGE_VAL;
+      }
+      value[i] = next_value[i];
+    }
+  }
+
+  xfree(next_value);
+}
+
+/*
+ * Fill in the analytic rates, utilizations and delays of every switch (see
+ * network.h). The number of unstable switches is returned.
+ */
+
+int
+network_solve(Network_Ptr network)
+{
+  double * constant;
+  double * value;
+  double rho;
+  int i, number_unstable = 0;
+  Switch_Ptr this_switch;
+
+  constant = (double *) xcalloc(network->number_of_switches, sizeof(double));
+  value = (double *) xcalloc(network->number_of_switches, sizeof(double));
+
+  /* The traffic equations. */
+  for (i=0; i<network->number_of_switches; i++)
+    constant[i] = network->switches[i].arrival_rate;
+  network_solve_routes(network, constant, value, 1);
+
+  for (i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    this_switch->total_arrival_rate = value[i];
+    rho = this_switch->utilization = value[i] * this_switch->service_time;
+
+    this_switch->analytic_delay = rho < 1 ?
+      this_switch->service_time +
+      rho * this_switch->service_time / (2 * (1 - rho)) : HUGE_VAL;
+    constant[i] = this_switch->analytic_delay;
+
+    if (network_switch_unstable(this_switch)) number_unstable++;
+  }
+
+  /* The delays from each switch until packets leave the network. */
+  network_solve_routes(network, constant, value, 0);
+  for (i=0; i<network->number_of_switches; i++)
+    network->switches[i].analytic_network_delay = value[i];
+
+  xfree(constant);
+  xfree(value);
+  return number_unstable;
+}
+
+/*
+ * Return 1 if network_solve found that the queue of this_switch grows without
+ * bound, i.e., it is offered more traffic than its link can carry and its
+ * buffer is not limited.
+ */
+
+int
+network_switch_unstable(Switch_Ptr this_switch)
+{
+  return this_switch->utilization >= 1 &&
+    this_switch->buffer_capacity == 0 && !this_switch->use_red;
+}
+
+/*
+ * Return 1 if the simulated mean delay of the packets from every switch is
+ * within tolerance, as a fraction, of the analytic one. An infinite analytic
+ * delay, e.g., behind a saturated switch with a limited buffer, never agrees.
+ */
+
+int
+network_delays_agree(Network_Ptr network, double tolerance)
+{
+  Switch_Ptr this_switch;
+  int i;
+
+  for (i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if (this_switch->packets_delivered == 0) continue;
+    if (!(this_switch->analytic_network_delay < HUGE_VAL)) return 0;
+    if (fabs(this_switch->accumulated_delay / this_switch->packets_delivered -
+	     this_switch->analytic_network_delay) >
+	tolerance * this_switch->analytic_network_delay)
+      return 0;
+  }
+  return 1;
+}
+
+/*
+ * Free a network. Packets still in its buffers or links are not freed.
+ */
+
+void
+network_free(Network_Ptr network)
+{
+  int i;
+
+  for (i=0; i<network->number_of_switches; i++) {
+    drift_detector_free(network->switches[i].queue_drift);
+    warmup_detector_free(network->switches[i].warmup);
+  }
+  xfree(network->switches);
+  xfree(network->routes);
+  xfree(network);
+}
+
@@ -0,0 +1,178 @@
+
+/*
+ *
+ * Simulation_Run of A Single Server Queueing System
+ *
+ * Copyright (C) 2014 Terence D. Todd Hamilton, Ontario, CANADA,
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/******************************************************************************/
+
+#ifndef _NETWORK_H_
+#define _NETWORK_H_
+
+/******************************************************************************/
+
+#include "simlib.h"
+
+/******************************************************************************/
+
+/*
+ * A network of packet switches read from a configuration file. Each switch
+ * has a buffer, an outgoing link and a Poisson stream of packets arriving from
+ * outside the network. A packet that finishes transmission on a switch's link
+ * moves on to another switch with the probability given by a route, or else
+ * leaves the network. The file has one line per switch followed by one line
+ * per route, e.g.,
+ *
+ *   # switch <number> <arrival rate (packets/s)> <link bit rate (bits/s)>
+ *   switch 1 750 2e6
+ *   switch 2 500 1e6
+ *   # route <from switch> <to switch> <probability>
+ *   route 1 2 0.7
+ *
+ * Switches are numbered from 1 in the order given. Everything on a line
+ * after a '#' is ignored.
+ *
+ * By default a switch's buffer can grow without limit. A buffer line limits it
+ * to a number of packets, and a packet that arrives to a full buffer is
+ * dropped (tail drop). A red line turns on Random Early Detection at a
+ * switch: an exponentially weighted average of the buffer length is kept, and
+ * a packet that would have to wait is dropped with a probability that rises
+ * from 0 to the maximum probability as the average goes from the minimum to
+ * the maximum threshold. Above the maximum threshold every such packet is
+ * dropped.
+ *
+ *   # buffer <switch> <packets>
+ *   buffer 2 100
+ *   # red <switch> <min threshold> <max threshold> <max probability> <weight>
+ *   red 2 20 60 0.1 0.002
+ *
+ * Each switch has a Drift_Detector on the buffer length seen by arriving
+ * packets, which finds out if its queue grows without bound, and a
+ * Warmup_Detector on the delays of the packets that entered the network
+ * there. When the warm-up is found to be over, the delay statistics of the
+ * switch are rolled back to the MSER truncation point.
+ *
+ * network_solve gives the analytic results for the same network. The total
+ * rate into each switch comes from the traffic equations
+ *
+ *   gamma_j = lambda_j + sum over i of gamma_i p_ij,
+ *
+ * and, as in a Jackson network, each switch is then treated as if its
+ * arrivals were Poisson. Packets have a fixed length, so the mean time at a
+ * switch is that of an M/D/1 queue, S + rho S / (2 (1 - rho)). The mean delay
+ * of a packet from its arrival at switch i until it leaves the network is
+ * D_i = W_i + sum over j of p_ij D_j. Drops are not modelled, so a switch with
+ * rho >= 1 has an infinite delay. Unless its buffer is limited, by a buffer or
+ * red line, it is unstable.
+ *
+ * The switches are kept in one array and the routes in another, with the
+ * routes leaving each switch stored together, so the memory used grows only
+ * with the number of switches and routes.
+ */
+
+#define NETWORK_MAX_LINE 256
+#define NETWORK_SOLVE_PRECISION 1e-12
+#define NETWORK_SOLVE_MAX_ITERATIONS 1000000
+
+typedef struct _route_
+{
+  int next_switch;
+  double cumulative_probability;
+} Route, * Route_Ptr;
+
+typedef struct _switch_
+{
+  Linkqueue buffer;
+  Server link;
+  int id;
+  double arrival_rate;
+  double link_bit_rate;
+  double service_time;
+  long int first_route;
+  int number_of_routes;
+  int carries_traffic;
+
+  long int buffer_capacity;
+  int use_red;
+  double red_min_threshold;
+  double red_max_threshold;
+  double red_max_probability;
+  double red_weight;
+  double red_average;
+  long int red_count;
+  Drift_Detector_Ptr queue_drift;
+  Warmup_Detector_Ptr warmup;
+
+  long int arrival_count;
+  long int number_of_packets_processed;
+  long int tail_drop_count;
+  long int red_drop_count;
+  long int packets_delivered;
+  long int packets_lost;
+  double accumulated_delay;
+
+  double total_arrival_rate;
+  double utilization;
+  double analytic_delay;
+  double analytic_network_delay;
+} Switch, * Switch_Ptr;
+
+typedef struct _network_
+{
+  Switch_Ptr switches;
+  int number_of_switches;
+  Route_Ptr routes;
+  long int number_of_routes;
+} Network, * Network_Ptr;
+
+/******************************************************************************/
+
+/*
+ * Function prototypes
+ */
+
+Network_Ptr
+network_new(const char *, double, long int);
+
+int
+network_switch_accepts(Switch_Ptr, Simulation_Run_Ptr);
+
+Switch_Ptr
+network_next_switch(Network_Ptr, Switch_Ptr, Simulation_Run_Ptr);
+
+int
+network_finished(Network_Ptr, long int);
+
+int
+network_solve(Network_Ptr);
+
+int
+network_switch_unstable(Switch_Ptr);
+
+int
+network_delays_agree(Network_Ptr, double);
+
+void
+network_free(Network_Ptr);
+
+/******************************************************************************/
+
+#endif /* network.h */
+
@@ -32,10 +32,11 @@
 
 /*
  * This function outputs a progress message to the screen to indicate this are
- * working.
+ * working. It is called each time this_switch sends a packet.
  */
 
-void output_progress_msg_to_screen(Simulation_Run_Ptr simulation_run)
+void output_progress_msg_to_screen(Simulation_Run_Ptr simulation_run,
+                                   Switch_Ptr this_switch)
 {
     double percentage_done;
     Simulation_Run_Data_Ptr data;
@@ -44,107 +45,160 @@ void output_progress_msg_to_screen(Simulation_Run_Ptr simulation_run)
 
     data->blip_counter++;
 
-    if(data->blip_counter >= BLIPRATE || data->number_of_packets_processed3 >= RUNLENGTH){
+    if(data->blip_counter >= BLIPRATE){
             data->blip_counter = 0;
-            percentage_done = 100 * (double) data->number_of_packets_processed/RUNLENGTH;
+            percentage_done = 100 * (double) this_switch->number_of_packets_processed/RUNLENGTH;
 
             printf("%3.0f%% ", percentage_done);
-            printf("Successfully Xmtted Pkts on Switch 1  = %ld (Arrived Pkts = %ld) \n", data->number_of_packets_processed, data->arrival_count);
+            printf("Successfully Xmtted Pkts on Switch %d  = %ld (Arrived Pkts = %ld) \n", this_switch->id, this_switch->number_of_packets_processed, this_switch->arrival_count);
 
             fflush(stdout);
     }
 }
 
-void output_progress_msg_to_screen2(Simulation_Run_Ptr simulation_run)
-{
-    double percentage_done;
-    Simulation_Run_Data_Ptr data;
-
-    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
-
-    data->blip_counter++;
-
-    if(data->blip_counter >= BLIPRATE || data->number_of_packets_processed2 >= RUNLENGTH){
-            data->blip_counter = 0;
-            percentage_done = 100 * (double) data->number_of_packets_processed2/RUNLENGTH;
-
-            printf("%3.0f%% ", percentage_done);
-            printf("Successfully Xmtted Pkts on Switch 2  = %ld (Arrived Pkts = %ld) \n", data->number_of_packets_processed2, data->arrival_count2);
-
-            fflush(stdout);
-    }
-
-}
-
-void output_progress_msg_to_screen3(Simulation_Run_Ptr simulation_run)
-{
-    double percentage_done;
-    Simulation_Run_Data_Ptr data;
-
-    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
-
-    data->blip_counter++;
-
-    if(data->blip_counter >= BLIPRATE || data->number_of_packets_processed3 >= RUNLENGTH){
-            data->blip_counter = 0;
-            percentage_done = 100 * (double) data->number_of_packets_processed3/RUNLENGTH;
-
-            printf("%3.0f%% ", percentage_done);
-            printf("Successfully Xmtted Pkts on Switch 3  = %ld (Arrived Pkts = %ld) \n", data->number_of_packets_processed3, data->arrival_count3);
-
-            fflush(stdout);
-    }
-
-}
-
 /*
  * When a simulation_run run is completed, this function outputs various
- * collected statistics on the screen.
+ * collected statistics on the screen. A packet's delay is counted at the
+ * switch where it entered the network, from its arrival there until it leaves
+ * the network.
  */
 
 void
 output_results(Simulation_Run_Ptr simulation_run)
 {
   double xmtted_fraction;
-  double xmtted_fraction2;
-  double xmtted_fraction3;
   Simulation_Run_Data_Ptr data;
+  Network_Ptr network;
+  Switch_Ptr this_switch;
+  long int delivered;
+  int i;
 
   data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
+  network = data->network;
 
   printf("\n");
   printf("Random Seed = %d \n", data->random_seed);
-  printf("Packet arrival count on Switch 1 = %ld \n", data->arrival_count);
-  printf("Packet arrival count on Switch 2 = %ld \n", data->arrival_count2);
-  printf("Packet arrival count on Switch 3 = %ld \n", data->arrival_count3);
-
-  xmtted_fraction = (double) data->number_of_packets_processed /
-    data->arrival_count;
-  xmtted_fraction2 = (double) data->number_of_packets_processed2 /
-    data->arrival_count2;
-  xmtted_fraction3 = (double) data->number_of_packets_processed3 /
-    data->arrival_count3;
-
-  printf("Transmitted packet count on Switch 1  = %ld (Service Fraction = %.5f)\n",
-	 data->number_of_packets_processed, xmtted_fraction);
-  printf("Transmitted packet count on Switch 2  = %ld (Service Fraction = %.5f)\n",
-	 data->number_of_packets_processed2, xmtted_fraction2);
-  printf("Transmitted packet count on Switch 3  = %ld (Service Fraction = %.5f)\n",
-	 data->number_of_packets_processed3, xmtted_fraction3);
-
-  printf("Arrival rate on Switch 1 = %.3f packets/second \n", (double) data->arrival_rate);
-  printf("Arrival rate on Switch 2 = %.3f packets/second \n", (double) data->arrival_rate_23);
-  printf("Arrival rate on Switch 3 = %.3f packets/second \n", (double) data->arrival_rate_23);
-
-  printf("Mean Delay for Packets Originating at Switch 1 (msec) = %.2f \n",
-	 1e3*data->accumulated_delay/data->number_of_packets_processed);
-  printf("Mean Delay for Packets Originating at Switch 2 (msec) = %.2f \n",
-	 1e3*data->accumulated_delay2/data->number_of_packets_processed2);
-  printf("Mean Delay for Packets Originating at Switch 3 (msec) = %.2f \n",
-	 1e3*data->accumulated_delay3/data->number_of_packets_processed3);
+
+  if(data->unstable_switch != NULL) {
+    printf("UNSTABLE: the queue at Switch %d grows by %.3g packets per arrival. The run was stopped at time %.3f and the results below are not steady state.\n",
+	   data->unstable_switch->id,
+	   drift_detector_slope(data->unstable_switch->queue_drift),
+	   simulation_run_get_time(simulation_run));
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    printf("Packet arrival count on Switch %d = %ld \n",
+	   this_switch->id, this_switch->arrival_count);
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    xmtted_fraction = (double) this_switch->number_of_packets_processed /
+      this_switch->arrival_count;
+    printf("Transmitted packet count on Switch %d  = %ld (Service Fraction = %.5f)\n",
+	   this_switch->id, this_switch->number_of_packets_processed,
+	   xmtted_fraction);
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if(this_switch->buffer_capacity > 0 || this_switch->use_red) {
+      printf("Dropped packet count on Switch %d = %ld (Tail Drop = %ld, RED = %ld, Drop Fraction = %.5f)\n",
+	     this_switch->id,
+	     this_switch->tail_drop_count + this_switch->red_drop_count,
+	     this_switch->tail_drop_count, this_switch->red_drop_count,
+	     (double) (this_switch->tail_drop_count +
+		       this_switch->red_drop_count) /
+	     this_switch->arrival_count);
+    }
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    printf("Arrival rate on Switch %d = %.3f packets/second \n",
+	   this_switch->id, this_switch->arrival_rate);
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    printf("Utilization of Switch %d = %.5f (analytic)\n",
+	   this_switch->id, this_switch->utilization);
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if(warmup_detector_done(this_switch->warmup)) {
+      printf("Warm-up packets discarded on Switch %d = %ld \n",
+	     this_switch->id,
+	     warmup_detector_truncation_point(this_switch->warmup));
+    }
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if(this_switch->packets_delivered > 0) {
+      printf("Mean Delay for Packets Originating at Switch %d (msec) = %.2f (analytic %.2f)\n",
+	     this_switch->id,
+	     1e3*this_switch->accumulated_delay/this_switch->packets_delivered,
+	     1e3*this_switch->analytic_network_delay);
+    }
+  }
+
+  /*
+   * Losses are counted over the whole run, so the packets delivered during
+   * the warm-up are added back.
+   */
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if(this_switch->packets_lost > 0) {
+      delivered = this_switch->packets_delivered;
+      if(warmup_detector_done(this_switch->warmup))
+	delivered += warmup_detector_truncation_point(this_switch->warmup);
+      printf("Loss Probability for Packets Originating at Switch %d = %.5f \n",
+	     this_switch->id,
+	     (double) this_switch->packets_lost /
+	     (this_switch->packets_lost + delivered));
+    }
+  }
 
   printf("\n\n");
 }
 
+/*
+ * Print the analytic results of a network that was not simulated.
+ */
+
+void
+output_analytic_results(Network_Ptr network)
+{
+  Switch_Ptr this_switch;
+  int i;
+
+  printf("\n");
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if(network_switch_unstable(this_switch)) {
+      printf("UNSTABLE: Switch %d is offered %.3f packets/second, more than its link can send. The network was not simulated.\n",
+	     this_switch->id, this_switch->total_arrival_rate);
+    }
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    printf("Utilization of Switch %d = %.5f (analytic)\n",
+	   this_switch->id, this_switch->utilization);
+  }
+
+  for(i=0; i<network->number_of_switches; i++) {
+    this_switch = network->switches + i;
+    if(this_switch->arrival_rate > 0) {
+      printf("Mean Delay for Packets Originating at Switch %d (msec) = %.2f (analytic)\n",
+	     this_switch->id, 1e3*this_switch->analytic_network_delay);
+    }
+  }
 
+  printf("\n\n");
+}
 
@@ -38,13 +38,15 @@
  */
 
 void
-output_progress_msg_to_screen(Simulation_Run_Ptr);
+output_progress_msg_to_screen(Simulation_Run_Ptr, Switch_Ptr);
 
 void
 output_results(Simulation_Run_Ptr);
 
+void
+output_analytic_results(Network_Ptr);
+
 /******************************************************************************/
 
 #endif /* output.h */
 
-
@@ -32,61 +32,22 @@
 /******************************************************************************/
 
 /*
- * This function will schedule a packet arrival at a time given by
- * event_time. At that time the function "packet_arrival" (located in
- * packet_arrival.c) is executed. An object can be attached to the event and
- * can be recovered in packet_arrival.c.
+ * This function will schedule a packet arrival from outside the network at
+ * this_switch at a time given by event_time. At that time the function
+ * "packet_arrival_event" (located in packet_arrival.c) is executed, with the
+ * switch attached to the event.
  */
 
 long int
 schedule_packet_arrival_event(Simulation_Run_Ptr simulation_run,
-			      double event_time)
-{
-  Event event;
-
-  event.description = "Packet Arrival on Switch 1";
-  event.function = packet_arrival_event;
-  event.attachment = (void *) NULL;
-
-  return simulation_run_schedule_event(simulation_run, event, event_time);
-}
-
-long int
-schedule_packet_arrival_event_2(Simulation_Run_Ptr simulation_run,
-			      double event_time)
-{
-  Event event;
-
-  event.description = "Packet Arrival on Switch 2";
-  event.function = packet_arrival_event_2;
-  event.attachment = (void *) NULL;
-
-  return simulation_run_schedule_event(simulation_run, event, event_time);
-}
-
-long int
-schedule_packet_arrival_event_3(Simulation_Run_Ptr simulation_run,
-			      double event_time)
-{
-  Event event;
-
-  event.description = "Packet Arrival on Switch 3";
-  event.function = packet_arrival_event_3;
-  event.attachment = (void *) NULL;
-
-  return simulation_run_schedule_event(simulation_run, event, event_time);
-}
-
-long int
-schedule_packet_arrival_event_wireless(Simulation_Run_Ptr simulation_run,
 			      double event_time,
-			      Packet_Ptr packet)
+			      Switch_Ptr this_switch)
 {
   Event event;
 
-  event.description = "Packet Arrival from Switch 1 to new Switch";
-  event.function = packet_arrival_event_wireless;
-  event.attachment = (void *) packet;
+  event.description = "Packet Arrival";
+  event.function = packet_arrival_event;
+  event.attachment = (void *) this_switch;
 
   return simulation_run_schedule_event(simulation_run, event, event_time);
 }
@@ -94,165 +55,77 @@ schedule_packet_arrival_event_wireless(Simulation_Run_Ptr simulation_run,
 /******************************************************************************/
 
 /*
- * This is the event function which is executed when a packet arrival event
- * occurs. It creates a new packet object and places it in either the fifo
- * queue if the server is busy. Otherwise it starts the transmission of the
- * packet. It then schedules the next packet arrival event.
+ * This is the event function which is executed when a packet arrives at a
+ * switch from outside the network. It creates a new packet object and hands it
+ * to the switch. It then schedules the next packet arrival event at the
+ * switch.
  */
 
-// This arrival event will handle Switch 1
 void
-packet_arrival_event(Simulation_Run_Ptr simulation_run, void * ptr)
+packet_arrival_event(Simulation_Run_Ptr simulation_run, void * switch_ptr)
 {
-    Simulation_Run_Data_Ptr data;
-    Packet_Ptr new_packet;
-
-    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
-    if(data->number_of_packets_processed <= RUNLENGTH){
-        data->arrival_count++;
+  Simulation_Run_Data_Ptr data;
+  Switch_Ptr this_switch;
+  Packet_Ptr new_packet;
 
-        new_packet = (Packet_Ptr) xmalloc(sizeof(Packet));
-        new_packet->arrive_time = simulation_run_get_time(simulation_run);
-        new_packet->service_time = get_packet_transmission_time();
-        new_packet->status = WAITING;
+  data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
+  this_switch = (Switch_Ptr) switch_ptr;
 
-        /*
-        * Start transmission if the data link is free. Otherwise put the packet into
-        * the buffer.
-        */
+  new_packet = (Packet_Ptr) pool_get(data->packet_pool);
+  new_packet->arrive_time = simulation_run_get_time(simulation_run);
+  new_packet->source_id = this_switch->id;
 
-        if(server_state(data->link) == BUSY) {
-            fifoqueue_put(data->buffer, (void*) new_packet);
-        } else {
-            start_transmission_on_link(simulation_run, new_packet, data->link);
-        }
+  switch_packet_arrival(simulation_run, this_switch, new_packet);
 
-        /*
-        * Schedule the next packet arrival. Independent, exponentially distributed
-        * interarrival times gives us Poisson process arrivals.
-        */
+  /*
+   * Schedule the next packet arrival. Independent, exponentially distributed
+   * interarrival times gives us Poisson process arrivals.
+   */
 
-        schedule_packet_arrival_event(simulation_run,
-                simulation_run_get_time(simulation_run) +
-                exponential_generator((double) 1/data->arrival_rate));
-    }
+  schedule_packet_arrival_event(simulation_run,
+	simulation_run_get_time(simulation_run) +
+	simulation_run_exponential_generator(simulation_run,
+					     (double) 1/this_switch->arrival_rate),
+	this_switch);
 }
 
-// This arrival event will handle Switch 2
-void
-packet_arrival_event_2(Simulation_Run_Ptr simulation_run, void * ptr)
-{
-    Simulation_Run_Data_Ptr data;
-    Packet_Ptr new_packet2;
-
-    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
-    if(data->number_of_packets_processed2 <= RUNLENGTH){
-        data->arrival_count2++;
-
-        new_packet2 = (Packet_Ptr) xmalloc(sizeof(Packet));
-        new_packet2->arrive_time = simulation_run_get_time(simulation_run);
-        new_packet2->service_time = get_packet_transmission_time_23();
-        new_packet2->status = WAITING;
-
-        /*
-        * Start transmission if the data link is free. Otherwise put the packet into
-        * the buffer. This will run for both links since they have the same properties
-        */
-
-        if(server_state(data->link2) == BUSY) {
-            //printf("Packet being buffered into Buffer 2\n");
-            fifoqueue_put(data->buffer2, (void*) new_packet2);
-        } else {
-            printf("Packet being sent to Link 2\n");
-            start_transmission_on_link2(simulation_run, new_packet2, data->link2);
-        }
-
-        /*
-        * Schedule the next packet arrival. Independent, exponentially distributed
-        * interarrival times gives us Poisson process arrivals.
-        */
-
-        schedule_packet_arrival_event_2(simulation_run,
-                simulation_run_get_time(simulation_run) +
-                exponential_generator((double) 1/data->arrival_rate_23));
-    }
-}
-
-// This arrival event will handle Switch 3
-void
-packet_arrival_event_3(Simulation_Run_Ptr simulation_run, void * ptr)
-{
-    Simulation_Run_Data_Ptr data;
-    Packet_Ptr new_packet3;
-
-    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
-    if(data->number_of_packets_processed3 <= RUNLENGTH){
-        data->arrival_count3++;
-
-        new_packet3 = (Packet_Ptr) xmalloc(sizeof(Packet));
-        new_packet3->arrive_time = simulation_run_get_time(simulation_run);
-        new_packet3->service_time = get_packet_transmission_time_23();
-        new_packet3->status = WAITING;
-
-        /*
-        * Start transmission if the data link is free. Otherwise put the packet into
-        * the buffer. This will run for both links since they have the same properties
-        */
-
-        if (server_state(data->link3) == BUSY) {
-            fifoqueue_put(data->buffer3, (void*) new_packet3);
-            //printf("Packet being buffered into Buffer 3\n");
-        } else {
-            printf("Packet being sent to Link 3\n");
-            start_transmission_on_link3(simulation_run, new_packet3, data->link3);
-        }
-
-        /*
-        * Schedule the next packet arrival. Independent, exponentially distributed
-        * interarrival times gives us Poisson process arrivals.
-        */
-
-        schedule_packet_arrival_event_3(simulation_run,
-                simulation_run_get_time(simulation_run) +
-                exponential_generator((double) 1/data->arrival_rate_23));
-    }
-}
+/*
+ * A packet arrives at this_switch, either from outside the network or from
+ * another switch. If the switch drops it, it is counted as lost to the switch
+ * where it entered the network. Otherwise start its transmission if the link
+ * is free, or else put the packet into the switch's buffer.
+ */
 
-// This arrival event will handle the transfer from switch 1 to switches 2 or 3
 void
-packet_arrival_event_wireless(Simulation_Run_Ptr simulation_run, Packet_Ptr packet, void * ptr)
+switch_packet_arrival(Simulation_Run_Ptr simulation_run,
+		      Switch_Ptr this_switch,
+		      Packet_Ptr packet)
 {
-    Simulation_Run_Data_Ptr data;
+  Simulation_Run_Data_Ptr data;
 
-    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
+  data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
 
-    packet->service_time = get_packet_transmission_time_23();
-    packet->status = WAITING;
+  this_switch->arrival_count++;
 
-    double p13 = 0.3;
+  /* Stop the run if the queue at this switch grows without bound. */
+  if(drift_detector_add(this_switch->queue_drift,
+                        (double) linkqueue_size(&this_switch->buffer))) {
+    data->unstable_switch = this_switch;
+  }
 
-    //time_t t;
-    //srand((unsigned) time(&t));
-    double random = (double)rand()/(double)RAND_MAX;
+  if(!network_switch_accepts(this_switch, simulation_run)) {
+    (data->network->switches + packet->source_id - 1)->packets_lost++;
+    pool_put(data->packet_pool, (void *) packet);
+    return;
+  }
 
-    // Determine using probability if the packet is to be sent to Switch 2 or 3
-    if(random <= p13){
-        data->arrival_count3++;
-        if (server_state(data->link3) == BUSY) {
-            fifoqueue_put(data->buffer3, (void*) packet);
-        } else {
-            start_transmission_on_link13(simulation_run, packet, data->link3);
-        }
-    } else {
-        data->arrival_count2++;
-        if (server_state(data->link2) == BUSY) {
-            fifoqueue_put(data->buffer2, (void*) packet);
-        } else {
-            start_transmission_on_link12(simulation_run, packet, data->link2);
-        }
-    }
+  packet->service_time = this_switch->service_time;
+  packet->status = WAITING;
 
+  if(server_state(&this_switch->link) == BUSY) {
+    linkqueue_put(&this_switch->buffer, &packet->queue_link);
+  } else {
+    start_transmission_on_link(simulation_run, packet, this_switch);
+  }
 }
 
-
-
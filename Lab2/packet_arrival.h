@@ -28,7 +28,7 @@
 
 /******************************************************************************/
 
-#include "simlib.h"
+#include "main.h"
 
 /******************************************************************************/
 
@@ -40,30 +40,12 @@ void
 packet_arrival_event(Simulation_Run_Ptr, void*);
 
 long
-schedule_packet_arrival_event(Simulation_Run_Ptr, double);
+schedule_packet_arrival_event(Simulation_Run_Ptr, double, Switch_Ptr);
 
 void
-packet_arrival_event_2(Simulation_Run_Ptr, void*);
-
-long
-schedule_packet_arrival_event_2(Simulation_Run_Ptr, double);
-
-void
-packet_arrival_event_3(Simulation_Run_Ptr, void*);
-
-long
-schedule_packet_arrival_event_3(Simulation_Run_Ptr, double);
-
-void
-packet_arrival_event_wireless(Simulation_Run_Ptr, Packet_Ptr packet, void*);
-
-long
-schedule_packet_arrival_event_wireless(Simulation_Run_Ptr, double, Packet_Ptr packet);
+switch_packet_arrival(Simulation_Run_Ptr, Switch_Ptr, Packet_Ptr);
 
 /******************************************************************************/
 
 #endif /* packet_arrival.h */
 
-
-
-
@@ -37,41 +37,12 @@
  */
 
 void
-start_transmission_on_link(Simulation_Run_Ptr, Packet_Ptr, Server_Ptr);
+start_transmission_on_link(Simulation_Run_Ptr, Packet_Ptr, Switch_Ptr);
 
 void
-start_transmission_on_link2(Simulation_Run_Ptr, Packet_Ptr, Server_Ptr);
-
-void
-start_transmission_on_link3(Simulation_Run_Ptr, Packet_Ptr, Server_Ptr);
-
-void
-start_transmission_on_link12(Simulation_Run_Ptr, Packet_Ptr, Server_Ptr);
-
-void
-start_transmission_on_link13(Simulation_Run_Ptr, Packet_Ptr, Server_Ptr);
-
-void
-end_packet_transmission_event_wireless(Simulation_Run_Ptr, void*);
-
-void
-end_packet_transmission_event_wireless12(Simulation_Run_Ptr, void*);
-
-void
-end_packet_transmission_event_wireless13(Simulation_Run_Ptr, void*);
-
-void
-end_packet_transmission_event_2(Simulation_Run_Ptr, void*);
-
-void
-end_packet_transmission_event_3(Simulation_Run_Ptr, void*);
-
-double
-get_packet_transmission_time(void);
+end_packet_transmission_event(Simulation_Run_Ptr, void*);
 
 /******************************************************************************/
 
 #endif /* packet_transmission.h */
 
-
-
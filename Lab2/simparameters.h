@@ -28,18 +28,30 @@
 
 /******************************************************************************/
 
-#define PACKET_ARRIVAL_RATE 400 /* packets per second */
-#define PACKET_ARRIVAL_RATE_LIST 400 /*, 468, 470, 472, 473, 474, 475, 400, 800, 1200, 1600, 1700, 1800, 1900, 1990, 1994, 1998, 2000*/
+/* The switches, their arrival and link bit rates and the routes between them. */
+#define NETWORK_FILE "network.cfg"
+
 #define PACKET_LENGTH 1e3 /* bits */
-#define LINK_BIT_RATE 2e6 /* bits per second for switch 1 */
-#define LINK_BIT_RATE_23 1e6 /* bits per second forr switches 2 and 3*/
-#define RUNLENGTH 10e6 /* packets */
+#define RUNLENGTH 10e6 /* packets per switch */
+
+/* Arrivals per batch when checking the switch queues for instability. */
+#define DRIFT_BATCH_SIZE 1000
+
+/*
+ * Do not simulate a network that network_solve finds to be unstable, and
+ * print only its analytic results.
+ */
+#define SKIP_UNSTABLE_NETWORKS 1
+
+/*
+ * Run no more seeds once the mean delays of a run are all within this
+ * fraction of the analytic ones. 0 runs every seed.
+ */
+#define AGREEMENT_TOLERANCE 0
 
 /* Comma separated list of random seeds to run. */
 #define RANDOM_SEED_LIST 333333, 444444, 400184842, 400167784, 400194367
 
-#define PACKET_XMT_TIME ((double) PACKET_LENGTH/LINK_BIT_RATE)
-#define PACKET_XMT_TIME_23 ((double) PACKET_LENGTH/LINK_BIT_RATE_23)
 #define BLIPRATE (RUNLENGTH/1000)
 
 /******************************************************************************/
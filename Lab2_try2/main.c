@@ -107,12 +107,14 @@ main(void)
         data.link  = server_new();
         data.link2 = server_new();
         data.link3 = server_new();
+        data.packet_pool = simulation_run_pool_new(simulation_run,
+                                                   sizeof(Packet));
 
         /*
          * Set the random number generator seed for this run.
          */
 
-        random_generator_initialize(random_seed);
+        simulation_run_random_generator_initialize(simulation_run, random_seed);
 
         /*
          * Schedule the initial packet arrival for the current clock time (= 0).
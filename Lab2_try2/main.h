@@ -42,6 +42,7 @@ typedef struct _simulation_run_data_
   Server_Ptr link;
   Server_Ptr link2;
   Server_Ptr link3;
+  Pool_Ptr packet_pool;
 
   int arrival_rate;
   int arrival_rate23;
@@ -95,7 +95,7 @@ packet_arrival_event(Simulation_Run_Ptr simulation_run, void * ptr)
     data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
     data->arrival_count++;
 
-    new_packet = (Packet_Ptr) xmalloc(sizeof(Packet));
+    new_packet = (Packet_Ptr) pool_get(data->packet_pool);
     new_packet->arrive_time = simulation_run_get_time(simulation_run);
     new_packet->service_time = get_packet_transmission_time();
     new_packet->status = WAITING;
@@ -120,7 +120,7 @@ packet_arrival_event(Simulation_Run_Ptr simulation_run, void * ptr)
 
     schedule_packet_arrival_event(simulation_run,
             simulation_run_get_time(simulation_run) +
-            exponential_generator((double) 1/data->arrival_rate));
+            simulation_run_exponential_generator(simulation_run, (double) 1/data->arrival_rate));
 }
 
 void
@@ -132,7 +132,7 @@ packet_arrival_event_2(Simulation_Run_Ptr simulation_run, void * ptr)
     data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
     data->arrival_count2++;
 
-    new_packet = (Packet_Ptr) xmalloc(sizeof(Packet));
+    new_packet = (Packet_Ptr) pool_get(data->packet_pool);
     new_packet->arrive_time = simulation_run_get_time(simulation_run);
     new_packet->service_time = get_packet_transmission_time_23();
     new_packet->status = WAITING;
@@ -157,7 +157,7 @@ packet_arrival_event_2(Simulation_Run_Ptr simulation_run, void * ptr)
 
     schedule_packet_arrival_event_2(simulation_run,
             simulation_run_get_time(simulation_run) +
-            exponential_generator((double) 1/data->arrival_rate23));
+            simulation_run_exponential_generator(simulation_run, (double) 1/data->arrival_rate23));
 }
 
 void
@@ -169,7 +169,7 @@ packet_arrival_event_3(Simulation_Run_Ptr simulation_run, void * ptr)
     data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
     data->arrival_count3++;
 
-    new_packet = (Packet_Ptr) xmalloc(sizeof(Packet));
+    new_packet = (Packet_Ptr) pool_get(data->packet_pool);
     new_packet->arrive_time = simulation_run_get_time(simulation_run);
     new_packet->service_time = get_packet_transmission_time_23();
     new_packet->status = WAITING;
@@ -194,7 +194,7 @@ packet_arrival_event_3(Simulation_Run_Ptr simulation_run, void * ptr)
 
     schedule_packet_arrival_event_3(simulation_run,
             simulation_run_get_time(simulation_run) +
-            exponential_generator((double) 1/data->arrival_rate23));
+            simulation_run_exponential_generator(simulation_run, (double) 1/data->arrival_rate23));
 }
 
 
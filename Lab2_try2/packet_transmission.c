@@ -85,7 +85,7 @@ end_packet_transmission_event(Simulation_Run_Ptr simulation_run, void * link)
         data->number_of_packets_processed++;
 
         double p13 = 0.5;
-        double random = (double)rand()/(double)RAND_MAX;
+        double random = simulation_run_uniform_generator(simulation_run);
 
 
         // Determine using probability if the packet is to be sent to Switch 2 or 3
@@ -109,7 +109,7 @@ end_packet_transmission_event(Simulation_Run_Ptr simulation_run, void * link)
     } else if (this_packet->sourceSwitch == 1 && this_packet->transfer == 1){
         data->accumulated_delay += simulation_run_get_time(simulation_run) - this_packet->arrive_time;
         output_progress_msg_to_screen(simulation_run);
-        xfree((void *) this_packet);
+        pool_put(data->packet_pool, (void *) this_packet);
         /*if(fifoqueue_size(data->buffer) > 0) {
             next_packet = (Packet_Ptr) fifoqueue_get(data->buffer);
             start_transmission_on_link(simulation_run, next_packet, link);
@@ -118,7 +118,7 @@ end_packet_transmission_event(Simulation_Run_Ptr simulation_run, void * link)
         data->accumulated_delay2 += simulation_run_get_time(simulation_run) - this_packet->arrive_time;
         data->number_of_packets_processed2++;
         output_progress_msg_to_screen(simulation_run);
-        xfree((void *) this_packet);
+        pool_put(data->packet_pool, (void *) this_packet);
         if(fifoqueue_size(data->buffer2) > 0) {
             next_packet = (Packet_Ptr) fifoqueue_get(data->buffer2);
             start_transmission_on_link(simulation_run, next_packet, link);
@@ -127,7 +127,7 @@ end_packet_transmission_event(Simulation_Run_Ptr simulation_run, void * link)
         data->accumulated_delay3 += simulation_run_get_time(simulation_run) - this_packet->arrive_time;
         data->number_of_packets_processed3++;
         output_progress_msg_to_screen(simulation_run);
-        xfree((void *) this_packet);
+        pool_put(data->packet_pool, (void *) this_packet);
         if(fifoqueue_size(data->buffer3) > 0) {
             next_packet = (Packet_Ptr) fifoqueue_get(data->buffer3);
             start_transmission_on_link(simulation_run, next_packet, link);
@@ -77,53 +77,32 @@ call_arrival_event(Simulation_Run_Ptr simulation_run, void * ptr)
     new_call->call_wait = get_wait_duration(simulation_run);
 
     /* See if there is a free channel.*/
-    if((free_channel = get_free_channel(simulation_run, sim_data->number_channels)) != NULL) {
+    if((free_channel = server_pool_acquire(sim_data->channels)) != NULL) {
         /* Yes, we found one.*/
         /* Place the call in the free channel and schedule its
            departure. */
         server_put(free_channel, (void*) new_call);
         new_call->channel = free_channel;
         sim_data->less_than_t++;
+        batch_means_add(sim_data->blocking_statistics, 0.0);
 
         schedule_end_call_on_channel_event(simulation_run,
                                            now + (new_call->call_duration),
                                            (void *) free_channel);
     } else {
         /* No free channel was found. The call is queue'd in and the customer departure is scheduled. */
-        fifoqueue_put(sim_data->buffer, (void*) new_call);
-
-        /*schedule_end_call_on_queue_event(simulation_run,
-                                         now + (new_call->call_wait),
-                                         fifoqueue_size(sim_data->buffer));*/
+        linkqueue_put(sim_data->buffer, &new_call->queue_link);
 
+        new_call->abandon_event_id =
+          schedule_end_call_on_queue_event(simulation_run,
+                                           now + (new_call->call_wait),
+                                           (void *) new_call);
     }
 
     /* Schedule the next call arrival. */
     schedule_call_arrival_event(simulation_run,
-          now + exponential_generator((double) 1/sim_data->arrival_rate));
+          now + simulation_run_exponential_generator(simulation_run, (double) 1/sim_data->arrival_rate));
 }
 
-/*******************************************************************************/
-
-/*
- * Scan through the channels and return a free one, if possible. Otherwise
- * return NULL.
- */
-
-Channel_Ptr get_free_channel(Simulation_Run_Ptr simulation_run, int NUMBER_OF_CHANNELS)
-{
-  Channel_Ptr *channels;
-  int i;
-  Simulation_Run_Data_Ptr sim_data;
-
-  sim_data = simulation_run_data(simulation_run);
-  channels = sim_data->channels;
-
-  for (i=0; i<NUMBER_OF_CHANNELS; i++) {
-    if (server_state(*(channels+i)) == FREE)
-      return *(channels+i);
-  }
-  return (Channel_Ptr) NULL;
-}
 
 
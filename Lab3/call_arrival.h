@@ -40,9 +40,6 @@
  *
  */
 
-Server_Ptr
-get_free_channel(Simulation_Run_Ptr, int);
-
 void
 call_arrival_event(Simulation_Run_Ptr, void *);
 
@@ -0,0 +1,118 @@
+
+/*
+ *
+ * Call Blocking in Circuit Switched Networks
+ *
+ * Copyright (C) 2014 Terence D. Todd
+ * Hamilton, Ontario, CANADA
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include "output.h"
+#include "simparameters.h"
+#include "erlang.h"
+#include "call_ctmc.h"
+
+/*******************************************************************************/
+
+/*
+ * Run the chain for the cell attached to simulation_run until the blocking
+ * probability is known precisely enough or RUNLENGTH calls have been
+ * processed. The same statistics are collected as by the event driven model,
+ * so output_results is unchanged.
+ */
+
+void
+run_ctmc(Simulation_Run_Ptr simulation_run)
+{
+  Simulation_Run_Data_Ptr sim_data;
+  double lambda, mu, theta, rate, holding_time, u;
+  double * wait_within_t = NULL;
+  long int table_size = 0;
+  long int n = 0, busy, queued;
+  int number_channels;
+
+  sim_data = simulation_run_data(simulation_run);
+
+  number_channels = sim_data->number_channels;
+  lambda = sim_data->arrival_rate;
+  mu = 1 / sim_data->call_duration;
+  theta = 1 / sim_data->queue_duration;
+
+  while(sim_data->number_of_calls_processed < RUNLENGTH &&
+	!batch_means_converged(sim_data->blocking_statistics,
+			       RELATIVE_PRECISION)) {
+
+    busy = n < number_channels ? n : number_channels;
+    queued = n - busy;
+
+    rate = lambda + busy * mu + queued * theta;
+    holding_time = 1 / rate;
+
+    sim_data->accumulated_call_time += busy * holding_time;
+    sim_data->accumulated_wait_time += queued * holding_time;
+
+    u = simulation_run_uniform_generator(simulation_run) * rate;
+
+    if(u < lambda) {
+      /* A call arrives. */
+      sim_data->call_arrival_count++;
+
+      if(busy < number_channels) {
+	sim_data->less_than_t++;
+	batch_means_add(sim_data->blocking_statistics, 0.0);
+      } else {
+	/* It joins the queue at position queued + 1. */
+	if(queued >= table_size) {
+	  /* Double the table, and fill it again for all positions at once. */
+	  table_size = 2 * table_size > queued + 1 ? 2 * table_size :
+	    queued + 1;
+	  wait_within_t = (double *)
+	    xrealloc(wait_within_t, table_size * sizeof(double));
+	  erlang_a_wait_within(table_size, number_channels, mu, theta, t,
+			       wait_within_t);
+	}
+	sim_data->less_than_t += wait_within_t[queued];
+	sim_data->customers_served_queue++;
+      }
+      n++;
+
+    } else if(u < lambda + busy * mu) {
+      /* A call ends. If a call is waiting, it takes over the channel. */
+      sim_data->number_of_calls_processed++;
+      if(queued > 0) batch_means_add(sim_data->blocking_statistics, 0.0);
+      output_progress_msg_to_screen(simulation_run);
+      n--;
+
+    } else {
+      /* A waiting caller gives up. */
+      sim_data->blocked_call_count++;
+      batch_means_add(sim_data->blocking_statistics, 1.0);
+      n--;
+    }
+  }
+
+  sim_data->queue_length = n > number_channels ? n - number_channels : 0;
+
+  if(wait_within_t != NULL) xfree((void *) wait_within_t);
+}
+
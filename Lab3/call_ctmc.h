@@ -0,0 +1,72 @@
+
+/*
+ *
+ * Call Blocking in Circuit Switched Networks
+ *
+ * Copyright (C) 2014 Terence D. Todd
+ * Hamilton, Ontario, CANADA
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*******************************************************************************/
+
+#ifndef _CALL_CTMC_H_
+#define _CALL_CTMC_H_
+
+/*******************************************************************************/
+
+#include "main.h"
+
+/*******************************************************************************/
+
+/*
+ * With Poisson arrivals, exponential call durations and exponential patience,
+ * the whole system is a birth-death chain in the number of calls present,
+ * n. min(n, N) of them hold channels and the rest wait. run_ctmc simulates
+ * only n. In state n the next event is an arrival (rate lambda), the end of a
+ * call (rate min(n, N) * mu) or a waiting caller giving up (rate
+ * max(n - N, 0) * theta), and it is picked with a single uniform random
+ * number. No Call objects or events are created.
+ *
+ * Time averages are collected with the expected holding time 1/rate of each
+ * state instead of a sampled one (discrete time conversion), which needs no
+ * random number and lowers the variance. The integral of the number of busy
+ * channels and of the queue length give the call and wait totals, as in
+ * Little's law.
+ *
+ * An arriving call that has to wait at position k of the queue is served
+ * within time t with a probability that depends only on k: it gives up at rate
+ * theta, and it moves up at rate N * mu + (j - 1) * theta from position j.
+ * This probability is added to less_than_t instead of the 0 or 1 outcome of a
+ * single call. It is computed with erlang_a_wait_within (erlang.h), for all
+ * positions up to the longest queue seen so far.
+ */
+
+/*******************************************************************************/
+
+/*
+ * Function prototypes
+ */
+
+void
+run_ctmc(Simulation_Run_Ptr);
+
+/*******************************************************************************/
+
+#endif /* call_ctmc.h */
+
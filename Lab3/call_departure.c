@@ -53,16 +53,20 @@ schedule_end_call_on_channel_event(Simulation_Run_Ptr simulation_run,
   return simulation_run_schedule_event(simulation_run, new_event, event_time);
 }
 
+/*
+ * Function to schedule the time at which a waiting call gives up.
+ */
+
 long int
 schedule_end_call_on_queue_event(Simulation_Run_Ptr simulation_run,
 				   double event_time,
-				   long int count)
+				   void * call)
 {
   Event new_event;
 
   new_event.description = "Caller Left Queue";
   new_event.function = end_call_on_queue_event;
-  new_event.attachment = count;
+  new_event.attachment = call;
 
   return simulation_run_schedule_event(simulation_run, new_event, event_time);
 }
@@ -70,7 +74,9 @@ schedule_end_call_on_queue_event(Simulation_Run_Ptr simulation_run,
 /*******************************************************************************/
 
 /*
- * Function which handles end of call events.
+ * Function which handles end of call events. The call at the front of the
+ * queue, if any, takes over the channel. Calls that gave up have already left
+ * the queue, so it is always still waiting.
  */
 
 void
@@ -102,59 +108,71 @@ end_call_on_channel_event(Simulation_Run_Ptr simulation_run, void * c_ptr)
     /* This call is done. Free up its allocated memory.*/
     xfree((void*) this_call);
 
-    while(fifoqueue_size(sim_data->buffer) > 0){
-        new_call = (Call_Ptr) fifoqueue_get(sim_data->buffer);
-        if(now-new_call->arrive_time < new_call->call_wait){
-            server_put(channel, (void*) new_call);
-            new_call->channel = channel;
-
-            if((now - new_call->arrive_time) < t){
-                sim_data->less_than_t++;
-            }
-
-            new_call->arrive_time = now;
-
-            sim_data->accumulated_wait_time += now - new_call->arrive_time;
-            sim_data->customers_served_queue++;
-
-            schedule_end_call_on_channel_event(simulation_run,
-                                               now + (new_call->call_duration),
-                                               (void *) channel);
-            break;
-        } else {
-            if(new_call->call_wait < t){
-                sim_data->less_than_t++;
-            }
-
-            sim_data->accumulated_wait_time += new_call->call_wait;
-            sim_data->customers_served_queue++;
-            sim_data->blocked_call_count++;
+    if(linkqueue_size(sim_data->buffer) > 0){
+        new_call = LINKQUEUE_OWNER(linkqueue_get(sim_data->buffer), Call,
+                                   queue_link);
+
+        /* It will not give up now. */
+        simulation_run_deschedule_event(simulation_run,
+                                        new_call->abandon_event_id);
+
+        server_put(channel, (void*) new_call);
+        new_call->channel = channel;
+
+        if((now - new_call->arrive_time) < t){
+            sim_data->less_than_t++;
         }
+
+        sim_data->accumulated_wait_time += now - new_call->arrive_time;
+        sim_data->customers_served_queue++;
+        batch_means_add(sim_data->blocking_statistics, 0.0);
+
+        /* From here on only the call itself is timed. */
+        new_call->arrive_time = now;
+
+        schedule_end_call_on_channel_event(simulation_run,
+                                           now + (new_call->call_duration),
+                                           (void *) channel);
+    }
+
+    /* Nobody took over the channel, so it is idle again. */
+    if(server_state(channel) == FREE) {
+        server_pool_release(sim_data->channels, channel);
     }
 }
 
+/*
+ * Function which handles a waiting call giving up. It is taken out of the
+ * queue, wherever it is, and counted as blocked.
+ */
+
 void
-end_call_on_queue_event(Simulation_Run_Ptr simulation_run, long int count)
+end_call_on_queue_event(Simulation_Run_Ptr simulation_run, void * c_ptr)
 {
+    Call_Ptr this_call;
     Simulation_Run_Data_Ptr sim_data;
     double now;
-    now = simulation_run_get_time(simulation_run);
 
+    this_call = (Call_Ptr) c_ptr;
+    now = simulation_run_get_time(simulation_run);
     sim_data = simulation_run_data(simulation_run);
 
     TRACE(printf("End Of Wait in Queue.\n"););
 
-    if(count == fifoqueue_size(sim_data->buffer)){
-        Call_Ptr this_call;
-        this_call = (Call_Ptr) fifoqueue_get(sim_data->buffer);
-
-        /* Collect statistics. */
-        sim_data->accumulated_call_time += now - this_call->arrive_time;
-        sim_data->customers_served_queue++;
+    linkqueue_remove(sim_data->buffer, &this_call->queue_link);
 
-        /* This call is done. Free up its allocated memory.*/
-        xfree((void*) this_call);
+    /* Collect statistics. */
+    if(this_call->call_wait < t){
+        sim_data->less_than_t++;
     }
+
+    sim_data->accumulated_wait_time += now - this_call->arrive_time;
+    sim_data->customers_served_queue++;
+    sim_data->blocked_call_count++;
+    batch_means_add(sim_data->blocking_statistics, 1.0);
+
+    /* This call is done. Free up its allocated memory.*/
+    xfree((void*) this_call);
 }
 
 
@@ -43,10 +43,10 @@ long int
 schedule_end_call_on_channel_event(Simulation_Run_Ptr, double, void*);
 
 void
-end_call_on_queue_event(Simulation_Run_Ptr ThisSimulation_Run, long int);
+end_call_on_queue_event(Simulation_Run_Ptr ThisSimulation_Run, void*);
 
 long int
-schedule_end_call_on_queue_event(Simulation_Run_Ptr, double, long int);
+schedule_end_call_on_queue_event(Simulation_Run_Ptr, double, void*);
 
 /*******************************************************************************/
 
@@ -35,7 +35,7 @@ double get_call_duration(Simulation_Run_Ptr simulation_run)
     Simulation_Run_Data_Ptr sim_data;
     sim_data = simulation_run_data(simulation_run);
 
-    return exponential_generator((double) sim_data->call_duration);
+    return simulation_run_exponential_generator(simulation_run, (double) sim_data->call_duration);
 }
 
 double get_wait_duration(Simulation_Run_Ptr simulation_run)
@@ -43,7 +43,7 @@ double get_wait_duration(Simulation_Run_Ptr simulation_run)
     Simulation_Run_Data_Ptr sim_data;
     sim_data = simulation_run_data(simulation_run);
 
-    return exponential_generator((double) sim_data->queue_duration);
+    return simulation_run_exponential_generator(simulation_run, (double) sim_data->queue_duration);
 }
 
 
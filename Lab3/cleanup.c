@@ -41,15 +41,16 @@ void cleanup (Simulation_Run_Ptr this_simulation_run)
 
     /* Clean out the channels. */
     for (i=0; i<sim_data->number_channels; i++) {
-        if( (*(sim_data->channels+i))->state == BUSY)
-            xfree(server_get(*(sim_data->channels+i)));
+        if(server_state(server_pool_server(sim_data->channels, i)) == BUSY)
+            xfree(server_get(server_pool_server(sim_data->channels, i)));
     }
-    xfree(sim_data->channels);
+    server_pool_free(sim_data->channels);
 
-    while (fifoqueue_size(sim_data->buffer) > 0){ /* Clean out the queue. */
-        xfree(fifoqueue_get(sim_data->buffer));
+    while (linkqueue_size(sim_data->buffer) > 0){ /* Clean out the queue. */
+        xfree(LINKQUEUE_OWNER(linkqueue_get(sim_data->buffer), Call, queue_link));
     }
-    xfree(sim_data->buffer);
+    linkqueue_free(sim_data->buffer);
+    batch_means_free(sim_data->blocking_statistics);
 
     /* Clean up the simulation_run. */
     simulation_run_free_memory(this_simulation_run);
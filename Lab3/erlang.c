@@ -0,0 +1,252 @@
+
+/*
+ *
+ * Call Blocking in Circuit Switched Networks
+ *
+ * Copyright (C) 2014 Terence D. Todd
+ * Hamilton, Ontario, CANADA
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*******************************************************************************/
+
+#include <math.h>
+#include "simlib.h"
+#include "erlang.h"
+
+/*******************************************************************************/
+
+/*
+ * Return the Erlang B blocking probability for the given offered load and
+ * number of channels.
+ */
+
+double
+erlang_b(double load, int number_channels)
+{
+  double blocking;
+
+  erlang_b_grid(&load, &blocking, 1, number_channels);
+  return blocking;
+}
+
+/*
+ * Return the Erlang C probability that a call has to wait for the given
+ * offered load and number of channels. It is 1 when the load is too large for
+ * the queue to be stable.
+ */
+
+double
+erlang_c(double load, int number_channels)
+{
+  double waiting;
+
+  erlang_c_grid(&load, &waiting, 1, number_channels);
+  return waiting;
+}
+
+/*******************************************************************************/
+
+/*
+ * Fill blocking[i] with the Erlang B blocking probability of load[i], for
+ * count loads and the same number of channels.
+ */
+
+void
+erlang_b_grid(const double * load, double * blocking, long int count,
+	      int number_channels)
+{
+  long int i;
+  int n;
+
+  for(i=0; i<count; i++) blocking[i] = 1.0;
+
+  for(n=1; n<=number_channels; n++)
+    for(i=0; i<count; i++)
+      blocking[i] = load[i] * blocking[i] / (n + load[i] * blocking[i]);
+}
+
+/*
+ * Fill waiting[i] with the Erlang C waiting probability of load[i], for count
+ * loads and the same number of channels. It uses
+ *
+ *   C(A, N) = N B(A, N) / (N - A (1 - B(A, N))).
+ */
+
+void
+erlang_c_grid(const double * load, double * waiting, long int count,
+	      int number_channels)
+{
+  long int i;
+
+  erlang_b_grid(load, waiting, count, number_channels);
+
+  for(i=0; i<count; i++) {
+    if(load[i] < number_channels)
+      waiting[i] = number_channels * waiting[i] /
+	(number_channels - load[i] * (1 - waiting[i]));
+    else
+      waiting[i] = 1.0;
+  }
+}
+
+/*******************************************************************************/
+
+/*
+ * Fill within[k] with the probability that a call which joins the queue at
+ * position k + 1 waits less than time_limit, for k = 0 .. positions - 1. The
+ * call leaves the queue when it gives up (rate theta) or when it reaches a
+ * channel, which takes a sum of exponential times with rates N * mu + (j - 1)
+ * * theta, j = k + 1 .. 1. The two are independent, so
+ *
+ *   P(W < t) = 1 - exp(-theta t) (1 - P(S <= t))
+ *
+ * where S is the time to reach a channel. P(S <= t) is found for every
+ * position in one pass by uniformization: with Lambda the largest of the
+ * rates, reached[k] is the probability of reaching a channel within m steps
+ * of rate Lambda, and P(S <= t) = sum Poisson(m; Lambda t) reached_m[k].
+ */
+
+void
+erlang_a_wait_within(long int positions, int number_channels, double mu,
+		     double theta, double time_limit, double * within)
+{
+  double * reached;
+  double lambda, log_lambda_t, poisson, mass = 0.0, move;
+  long int k, m;
+
+  for(k=0; k<positions; k++) within[k] = 0.0;
+
+  lambda = number_channels * mu + (positions - 1) * theta;
+
+  if(time_limit > 0.0) {
+    reached = (double *) xcalloc((unsigned) positions, sizeof(double));
+    log_lambda_t = log(lambda * time_limit);
+
+    for(m=0; mass < 1 - ERLANG_EPSILON; m++) {
+      poisson = exp(-lambda * time_limit + m * log_lambda_t - lgamma(m + 1.0));
+      mass += poisson;
+      for(k=0; k<positions; k++) within[k] += poisson * reached[k];
+
+      /*
+       * One uniformized step: from position k + 1 the call moves up with
+       * probability (N mu + k theta) / Lambda. Position 0 is a channel.
+       */
+      for(k=positions-1; k>=0; k--) {
+	move = (number_channels * mu + k * theta) / lambda;
+	reached[k] = move * (k > 0 ? reached[k-1] : 1.0) +
+	  (1 - move) * reached[k];
+      }
+    }
+
+    xfree((void *) reached);
+  }
+
+  for(k=0; k<positions; k++)
+    within[k] = 1 - exp(-theta * time_limit) * (1 - within[k]);
+}
+
+/*******************************************************************************/
+
+/*
+ * Return -log B(A, N). This is the same recursion as erlang_b_grid, written
+ * for log(1 / B), which stays finite when B underflows at light loads.
+ */
+
+static double
+erlang_b_log_inverse(double load, int number_channels)
+{
+  double log_inverse = 0.0, x;
+  int n;
+
+  for(n=1; n<=number_channels; n++) {
+    x = log(n / load) + log_inverse;
+    log_inverse = x > 0 ? x + log1p(exp(-x)) : log1p(exp(x));
+  }
+  return log_inverse;
+}
+
+/*******************************************************************************/
+
+/*
+ * Solve the Erlang-A model with arrival rate lambda, call completion rate mu
+ * and give up rate theta > 0 on number_channels channels, and fill in
+ * results. time_limit is the t of probability_wait_within.
+ *
+ * All sums are scaled by their largest term, so that heavy loads with little
+ * abandonment do not overflow. The queue sum is stopped once its terms are
+ * falling and negligible.
+ */
+
+void
+erlang_a(double lambda, double mu, double theta, int number_channels,
+	 double time_limit, Erlang_A_Ptr results)
+{
+  double log_below, log_term, log_peak, weight, total, waiting, queue;
+  double within;
+  double * wait_within;
+  long int k, positions;
+
+  /* The states with a free channel, relative to the one with all busy. */
+  log_below = erlang_b_log_inverse(lambda / mu, number_channels);
+
+  /* The queue terms grow while lambda > N mu + k theta. */
+  log_peak = 0.0;
+  for(k=1; lambda > number_channels * mu + k * theta; k++)
+    log_peak += log(lambda / (number_channels * mu + k * theta));
+  if(log_below > log_peak) log_peak = log_below;
+
+  /* Calls arriving with a channel free wait 0. */
+  total = within = exp(log_below - log_peak) - exp(-log_peak);
+  waiting = queue = 0.0;
+
+  /* State N + k, where an arriving call joins the queue at position k + 1. */
+  log_term = 0.0;
+  for(k=0; ; k++) {
+    weight = exp(log_term - log_peak);
+    total += weight;
+    waiting += weight;
+    queue += k * weight;
+
+    if(lambda <= number_channels * mu + (k + 1) * theta &&
+       weight < ERLANG_EPSILON * total)
+      break;
+
+    log_term += log(lambda / (number_channels * mu + (k + 1) * theta));
+  }
+  positions = k + 1;
+
+  wait_within = (double *) xcalloc((unsigned) positions, sizeof(double));
+  erlang_a_wait_within(positions, number_channels, mu, theta, time_limit,
+		       wait_within);
+
+  log_term = 0.0;
+  for(k=0; k<positions; k++) {
+    within += exp(log_term - log_peak) * wait_within[k];
+    log_term += log(lambda / (number_channels * mu + (k + 1) * theta));
+  }
+  xfree((void *) wait_within);
+
+  results->probability_wait = waiting / total;
+  results->mean_queue_length = queue / total;
+  results->probability_abandon = theta * results->mean_queue_length / lambda;
+  results->mean_wait = results->mean_queue_length /
+    (lambda * results->probability_wait);
+  results->probability_wait_within = within / total;
+}
+
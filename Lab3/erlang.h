@@ -0,0 +1,88 @@
+
+/*
+ *
+ * Call Blocking in Circuit Switched Networks
+ *
+ * Copyright (C) 2014 Terence D. Todd
+ * Hamilton, Ontario, CANADA
+ * todd@mcmaster.ca
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*******************************************************************************/
+
+#ifndef _ERLANG_H_
+#define _ERLANG_H_
+
+/*******************************************************************************/
+
+/*
+ * Analytic results for N channels offered Poisson calls with exponential
+ * durations. The offered load A is the arrival rate times the mean call
+ * duration, in Erlangs.
+ *
+ * Erlang B (no waiting room) and Erlang C (callers wait forever) are found
+ * with the recursion B(A, n) = A B(A, n-1) / (n + A B(A, n-1)), B(A, 0) = 1,
+ * which stays between 0 and 1 and so cannot overflow, unlike summing
+ * A^n / n! directly. The _grid versions run it for many loads at once, with
+ * the loads in the inner loop so that it vectorizes.
+ *
+ * Erlang-A (M/M/N+M) adds exponential patience with rate theta, which is the
+ * model simulated in this lab. Its state probabilities are taken relative to
+ * the state with all N channels busy: below it they sum to 1/B(A, N), above
+ * it the k-th term is the product of lambda / (N mu + j theta), j = 1 .. k.
+ */
+
+#define ERLANG_EPSILON 1e-12
+
+typedef struct _erlang_a_
+{
+  double probability_wait;        /* an arriving call finds no free channel */
+  double probability_abandon;     /* an arriving call gives up */
+  double mean_queue_length;
+  double mean_wait;               /* mean time in queue of calls that wait */
+  double probability_wait_within; /* an arriving call waits less than t */
+} Erlang_A, * Erlang_A_Ptr;
+
+/*******************************************************************************/
+
+/*
+ * Function prototypes
+ */
+
+double
+erlang_b(double, int);
+
+double
+erlang_c(double, int);
+
+void
+erlang_b_grid(const double *, double *, long int, int);
+
+void
+erlang_c_grid(const double *, double *, long int, int);
+
+void
+erlang_a_wait_within(long int, int, double, double, double, double *);
+
+void
+erlang_a(double, double, double, int, double, Erlang_A_Ptr);
+
+/*******************************************************************************/
+
+#endif /* erlang.h */
+
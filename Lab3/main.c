@@ -33,20 +33,95 @@
 #include "simparameters.h"
 #include "cleanup.h"
 #include "call_arrival.h"
+#include "call_ctmc.h"
 #include "main.h"
 
 /*******************************************************************************/
 
+/*
+ * Run the simulation for one cell of the parameter grid. The parameters of the
+ * run have already been filled into the cell's data by main(). This is called
+ * by sweep_run, possibly on several threads at once.
+ */
+
+void
+run_grid_cell(void * cell_ptr)
+{
+  Grid_Cell_Ptr cell;
+  Simulation_Run_Ptr simulation_run;
+  Simulation_Run_Data_Ptr data;
+
+  cell = (Grid_Cell_Ptr) cell_ptr;
+  data = &cell->data;
+
+  /* Create a new simulation_run. This gives a clock and eventlist. */
+  simulation_run = simulation_run_new();
+  cell->simulation_run = simulation_run;
+
+  /* Add our data definitions to the simulation_run. */
+  simulation_run_set_data(simulation_run, (void *) data);
+
+  /* Initialize our simulation_run data variables. */
+  data->blip_counter = 0;
+  data->call_arrival_count = 0;
+
+  data->calls_processed = 0;
+  data->blocked_call_count = 0;
+
+  data->number_of_calls_processed = 0;
+  data->customers_served_queue = 0;
+  data->less_than_t = 0;
+  data->queue_length = 0;
+
+  data->accumulated_call_time = 0.0;
+  data->accumulated_wait_time = 0.0;
+  data->blocking_statistics = batch_means_new(BATCH_SIZE);
+
+  /* Create the channels. */
+  data->channels = server_pool_new(data->number_channels);
+
+  /* Initialize the queue*/
+  data->buffer = linkqueue_new();
+
+  /* The analytic results for this cell. */
+  erlang_a(data->arrival_rate, 1 / data->call_duration,
+           1 / data->queue_duration, data->number_channels, t,
+           &data->analytic);
+
+  if (SKIP_EXACT_CELLS) return;
+
+  /* Set the random number generator seed. */
+  simulation_run_random_generator_initialize(simulation_run, data->random_seed);
+
+  if (USE_CTMC_ENGINE) {
+    run_ctmc(simulation_run);
+    return;
+  }
+
+  /* Schedule the initial call arrival. */
+  schedule_call_arrival_event(simulation_run,
+          simulation_run_get_time(simulation_run) +
+          simulation_run_exponential_generator(simulation_run, (double) 1/data->arrival_rate));
+
+  /* Execute events until the blocking probability is known precisely enough,
+     or RUNLENGTH calls have been processed. */
+  while(data->number_of_calls_processed < RUNLENGTH &&
+        !batch_means_converged(data->blocking_statistics, RELATIVE_PRECISION)) {
+    simulation_run_execute_event(simulation_run);
+  }
+}
+
+/*******************************************************************************/
+
 int main(void)
 {
-  int i;
   int j=0;
   int k;
   int n;
   int m;
-
-  Simulation_Run_Ptr simulation_run;
-  Simulation_Run_Data data; /* Simulation_Run_Data is defined in main.h. */
+  long int cell_index;
+  long int number_of_cells;
+  Grid_Cell_Ptr cells;
 
   /*
    * Get the list of random number generator seeds defined in simparameters.h.
@@ -63,83 +138,67 @@ int main(void)
 
   double LIST_CALL_DURATION[] = {MEAN_CALL_DURATION, 0};
   double call_duration;
+  long int number_of_call_durations =
+    sizeof(LIST_CALL_DURATION)/sizeof(LIST_CALL_DURATION[0]) - 1;
 
-  unsigned Call_ARRIVALRATE = List_ARRIVALRATE;
+  /* Offered loads and their Erlang B and C results, one per call duration. */
+  double call_loads[sizeof(LIST_CALL_DURATION)/sizeof(LIST_CALL_DURATION[0])];
+  double erlang_b_values[sizeof(LIST_CALL_DURATION)/sizeof(LIST_CALL_DURATION[0])];
+  double erlang_c_values[sizeof(LIST_CALL_DURATION)/sizeof(LIST_CALL_DURATION[0])];
 
+  unsigned Call_ARRIVALRATE = List_ARRIVALRATE;
 
   /*
-   * Loop for each random number generator seed, doing a separate
-   * simulation_run run for each.
+   * Build the grid with one cell for each combination of random number
+   * generator seed, queue duration, number of channels and call duration.
    */
 
+  number_of_cells = (sizeof(RANDOM_SEEDS)/sizeof(RANDOM_SEEDS[0]) - 1) *
+    (sizeof(LIST_QUEUE_DURATION)/sizeof(LIST_QUEUE_DURATION[0]) - 1) *
+    (sizeof(LIST_CHANNELS)/sizeof(LIST_CHANNELS[0]) - 1) *
+    (sizeof(LIST_CALL_DURATION)/sizeof(LIST_CALL_DURATION[0]) - 1);
+
+  cells = (Grid_Cell_Ptr) xcalloc(number_of_cells, sizeof(Grid_Cell));
+  cell_index = 0;
+
     while ((random_seed = RANDOM_SEEDS[j++]) != 0) {
         k = 0;
         while((queue_duration = LIST_QUEUE_DURATION[k++]) != 0){
             n = 0;
             while((NUMBER_OF_CHANNELS = LIST_CHANNELS[n++]) != 0){
+                for(m = 0; m < number_of_call_durations; m++)
+                    call_loads[m] = Call_ARRIVALRATE * LIST_CALL_DURATION[m];
+                erlang_b_grid(call_loads, erlang_b_values,
+                              number_of_call_durations, NUMBER_OF_CHANNELS);
+                erlang_c_grid(call_loads, erlang_c_values,
+                              number_of_call_durations, NUMBER_OF_CHANNELS);
+
                 m = 0;
                 while((call_duration = LIST_CALL_DURATION[m++]) != 0){
-                    /* Create a new simulation_run. This gives a clock and eventlist. */
-                    simulation_run = simulation_run_new();
-
-                    /* Add our data definitions to the simulation_run. */
-                    simulation_run_set_data(simulation_run, (void *) & data);
-
-                    /* Initialize our simulation_run data variables. */
-                    data.blip_counter = 0;
-                    data.call_arrival_count = 0;
-
-                    data.calls_processed = 0;
-                    data.blocked_call_count = 0;
-
-                    data.number_of_calls_processed = 0;
-                    data.customers_served_queue = 0;
-                    data.less_than_t = 0;
-
-                    data.accumulated_call_time = 0.0;
-                    data.accumulated_wait_time = 0.0;
-
-                    data.random_seed = random_seed;
-                    data.arrival_rate = Call_ARRIVALRATE;
-                    data.number_channels = NUMBER_OF_CHANNELS;
-                    data.queue_duration = queue_duration;
-                    data.call_duration = call_duration;
-
-                    /* Create the channels. */
-                    data.channels = (Channel_Ptr *) xcalloc((int) NUMBER_OF_CHANNELS,
-                                        sizeof(Channel_Ptr));
-
-                    /* Initialize the channels. */
-                    for (i=0; i<NUMBER_OF_CHANNELS; i++) {
-                      *(data.channels+i) = server_new();
-                    }
-
-                    /* Initialize the queue*/
-                    data.buffer = fifoqueue_new();
-
-                    /* Set the random number generator seed. */
-                    random_generator_initialize((unsigned) random_seed);
-
-                    /* Schedule the initial call arrival. */
-                    schedule_call_arrival_event(simulation_run,
-                            simulation_run_get_time(simulation_run) +
-                            exponential_generator((double) 1/data.arrival_rate));
-
-                    /* Execute events until we are finished. */
-                    while(data.number_of_calls_processed < RUNLENGTH) {
-                        simulation_run_execute_event(simulation_run);
-                    }
-
-                    /* Print out some results. */
-                    output_results(simulation_run);
-
-                    /* Clean up memory. */
-                    cleanup(simulation_run);
+                    cells[cell_index].data.random_seed = random_seed;
+                    cells[cell_index].data.arrival_rate = Call_ARRIVALRATE;
+                    cells[cell_index].data.number_channels = NUMBER_OF_CHANNELS;
+                    cells[cell_index].data.queue_duration = queue_duration;
+                    cells[cell_index].data.call_duration = call_duration;
+                    cells[cell_index].data.erlang_b = erlang_b_values[m-1];
+                    cells[cell_index].data.erlang_c = erlang_c_values[m-1];
+                    cell_index++;
                 }
             }
         }
     }
 
+    /* Run every cell of the grid, spread across NUMBER_OF_THREADS threads. */
+    sweep_run((void *) cells, number_of_cells, sizeof(Grid_Cell),
+              run_grid_cell, NUMBER_OF_THREADS);
+
+    /* Print out the results in grid order and clean up memory. */
+    for (cell_index = 0; cell_index < number_of_cells; cell_index++) {
+        output_results(cells[cell_index].simulation_run);
+        cleanup(cells[cell_index].simulation_run);
+    }
+    xfree((void *) cells);
+
     /* Pause before finishing. */
     getchar();
     return 0;
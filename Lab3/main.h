@@ -31,6 +31,7 @@
 /*******************************************************************************/
 
 #include "simlib.h"
+#include "erlang.h"
 
 /*******************************************************************************/
 
@@ -39,18 +40,27 @@ typedef Server_Ptr Channel_Ptr;
 
 typedef enum {XMTTING, WAITING} Call_Status;
 
+/*
+ * A call that finds every channel busy waits on the buffer, a Linkqueue, and
+ * gives up once it has waited call_wait. abandon_event_id is its abandonment
+ * event, which is descheduled if it gets a channel first.
+ */
+
 typedef struct _call_
 {
+  Queue_Link queue_link;
   double arrive_time;
   double call_duration;
   double call_wait;
+  long int abandon_event_id;
   Channel_Ptr channel;
 } Call, * Call_Ptr;
 
 typedef struct _simulation_run_data_
 {
-  Channel_Ptr * channels;
-  Fifoqueue_Ptr buffer;
+  Server_Pool_Ptr channels;
+  Linkqueue_Ptr buffer;
+  Batch_Means_Ptr blocking_statistics;
   int arrival_rate;
   int number_channels;
   double queue_duration;
@@ -62,20 +72,41 @@ typedef struct _simulation_run_data_
   long int blocked_call_count;
   long int number_of_calls_processed;
   long int customers_served_queue;
-  long int less_than_t;
+  long int queue_length;
+  double less_than_t;
 
   double accumulated_call_time;
   double accumulated_wait_time;
+
+  Erlang_A analytic;
+  double erlang_b;
+  double erlang_c;
   unsigned random_seed;
 
 } Simulation_Run_Data, * Simulation_Run_Data_Ptr;
 
 /*******************************************************************************/
 
+/*
+ * One point of the parameter grid. Each cell has its own simulation_run and
+ * data, which are kept until the results of every cell have been printed.
+ */
+
+typedef struct _grid_cell_
+{
+  Simulation_Run_Ptr simulation_run;
+  Simulation_Run_Data data;
+} Grid_Cell, * Grid_Cell_Ptr;
+
+/*******************************************************************************/
+
 /*
  * Function prototypes
  */
 
+void
+run_grid_cell(void *);
+
 extern int main(void);
 
 /*******************************************************************************/
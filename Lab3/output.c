@@ -60,6 +60,31 @@ void output_progress_msg_to_screen(Simulation_Run_Ptr this_simulation_run)
 
 /*******************************************************************************/
 
+/*
+ * Print the analytic results of a cell that was not simulated.
+ */
+
+static void output_analytic_results(Simulation_Run_Data_Ptr sim_data)
+{
+  printf("\n");
+
+  printf("average call service duration = %.1f \n", sim_data->call_duration);
+  printf("average call wait duration (w) = %.1f \n", sim_data->queue_duration);
+  printf("number of channels (N) = %d \n", sim_data->number_channels);
+  printf("probability that call waited less than t=%1d : %.5f (analytic)\n", t,
+         sim_data->analytic.probability_wait_within);
+  printf("mean waiting time in queue = %.5f (analytic)\n",
+         sim_data->analytic.mean_wait);
+  printf("Blocking probability = %.5f (analytic)\n",
+         sim_data->analytic.probability_abandon);
+  printf("Erlang B = %.5f, Erlang C = %.5f \n\n",
+         sim_data->erlang_b, sim_data->erlang_c);
+
+  printf("\n");
+}
+
+/*******************************************************************************/
+
 void output_results(Simulation_Run_Ptr this_simulation_run)
 {
   double xmtted_fraction;
@@ -70,6 +95,11 @@ void output_results(Simulation_Run_Ptr this_simulation_run)
 
   sim_data = (Simulation_Run_Data_Ptr) simulation_run_data(this_simulation_run);
 
+  if (SKIP_EXACT_CELLS) {
+    output_analytic_results(sim_data);
+    return;
+  }
+
   waitTime = (double)sim_data->accumulated_wait_time/sim_data->customers_served_queue;
   callTime = (double)sim_data->accumulated_call_time/sim_data->number_of_calls_processed;
 
@@ -79,20 +109,28 @@ void output_results(Simulation_Run_Ptr this_simulation_run)
   printf("random seed = %d \n", sim_data->random_seed);
   printf("call arrival count = %ld \n", sim_data->call_arrival_count);
   printf("blocked call count = %ld \n", sim_data->blocked_call_count);
-  printf("queue size count = %ld \n\n", fifoqueue_size(sim_data->buffer));
+  printf("queue size count = %ld \n\n",
+         USE_CTMC_ENGINE ? sim_data->queue_length :
+         (long int) linkqueue_size(sim_data->buffer));
   printf("average call service duration = %.1f \n", sim_data->call_duration);
   printf("average call wait duration (w) = %.1f \n", sim_data->queue_duration);
-  printf("probability that call waited less than t=%1d : %.5f \n", t, (double)sim_data->less_than_t/sim_data->call_arrival_count);
+  printf("probability that call waited less than t=%1d : %.5f (analytic %.5f)\n", t, (double)sim_data->less_than_t/sim_data->call_arrival_count,
+         sim_data->analytic.probability_wait_within);
   printf("number of channels (N) = %d \n", sim_data->number_channels);
   printf("offered load (A) = %.5f \n", sim_data->arrival_rate * (callTime + waitTime));
-  printf("mean waiting time in queue = %.5f \n", waitTime);
+  printf("mean waiting time in queue = %.5f (analytic %.5f)\n", waitTime,
+         sim_data->analytic.mean_wait);
   printf("mean time in system = %.5f \n", (callTime + waitTime));
 
   xmtted_fraction = (double) (sim_data->call_arrival_count -
       sim_data->blocked_call_count)/sim_data->call_arrival_count;
 
-  printf("Blocking probability = %.5f (Service fraction = %.5f)\n\n",
-	 1-xmtted_fraction, xmtted_fraction);
+  printf("Blocking probability = %.5f (95%% CI +/- %.5f) (Service fraction = %.5f)\n",
+	 1-xmtted_fraction, batch_means_half_width(sim_data->blocking_statistics),
+	 xmtted_fraction);
+  printf("Analytic blocking probability = %.5f (Erlang B = %.5f, Erlang C = %.5f)\n\n",
+	 sim_data->analytic.probability_abandon, sim_data->erlang_b,
+	 sim_data->erlang_c);
 
   printf("\n");
 }
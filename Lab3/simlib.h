@@ -28,6 +28,8 @@
 /******************************************************************************/
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /******************************************************************************/
 
@@ -40,19 +42,28 @@ struct _simulation_run_;
 struct _clock_;
 struct _event_;
 struct _event_container_;
-struct _event_list_;
+struct _event_slab_;
+struct _eventlist_;
+struct _arena_;
+struct _rand_stream_;
 
 /*
  * Define some convenient typedefs to use when writing simulation_runs.
  *
  * The simulation_run consists of an event list, clock and a pointer for
- * passing user data between various functions.
+ * passing user data between various functions. Each run also has its own
+ * random number stream and event id counter, so that separate runs share no
+ * mutable state and can be executed at the same time.
  */
 
 typedef struct _simulation_run_
 {
   struct _eventlist_ * eventlist;
   struct _clock_ * clock;
+  struct _event_slab_ * event_slab;
+  struct _arena_ * arena;
+  struct _rand_stream_ * rand_stream;
+  long int next_event_id;
   void * data;
 } Simulation_Run, * Simulation_Run_Ptr;
 
@@ -81,38 +92,201 @@ typedef struct _event_container_
   double occurrence_time;
   void * data_ptr;
   long int event_id;
+  long int heap_index;
 } Event_Container, * Event_Container_Ptr;
 
+/*
+ * Event containers are taken from a slab owned by the simulation_run instead
+ * of being malloc'd one at a time. The slab gets pages of EVENT_SLAB_PAGE_SIZE
+ * containers as they are needed and keeps released containers on a free list
+ * threaded through next_container, so once the event list has reached its
+ * largest size, scheduling and executing events does no memory allocation. The
+ * pages come from the run arena (below) and are released along with it.
+ */
+
+#define EVENT_SLAB_PAGE_SIZE 256
+
+typedef struct _event_slab_
+{
+  struct _event_container_ * free_list;
+  struct _arena_ * arena;
+  long int page_count;
+  long int containers_in_use;
+  long int containers_allocated;
+} Event_Slab, * Event_Slab_Ptr;
+
+/*
+ * Each simulation_run owns an arena, a bump allocator which hands out memory
+ * for things that live as long as the run does. The arena takes blocks of
+ * ARENA_BLOCK_SIZE bytes at a time and never frees anything individually;
+ * simulation_run_free_memory releases all of its blocks at once. On Linux the
+ * blocks can optionally be backed by huge pages, which cuts TLB misses in long
+ * runs with many live objects.
+ *
+ * The first block is taken when the run is created, for its event slab and
+ * random stream, so huge pages are chosen at compile time with
+ * ARENA_HUGE_PAGES, e.g., -DARENA_HUGE_PAGES=1. simulation_run_set_huge_pages
+ * only changes the blocks taken after it is called.
+ */
+
+#define ARENA_BLOCK_SIZE (2UL << 20)
+#define ARENA_ALIGNMENT 16
+
+#ifndef ARENA_HUGE_PAGES
+#define ARENA_HUGE_PAGES 0
+#endif
+
+typedef struct _arena_block_
+{
+  struct _arena_block_ * next_block;
+  unsigned long size;
+  unsigned long used;
+  int mapped;
+} Arena_Block, * Arena_Block_Ptr;
+
+typedef struct _arena_
+{
+  struct _arena_block_ * blocks;
+  unsigned long bytes_allocated;
+  int use_huge_pages;
+} Arena, * Arena_Ptr;
+
+/*
+ * The event list can be kept in one of the following forms. LINKED_EVENTLIST
+ * is a time ordered doubly linked list, which is cheap when nearly every new
+ * event goes to the back of the list but costs O(n) for each insertion into
+ * the middle. HEAP_EVENTLIST keeps the events in an implicit d-ary heap, so
+ * that insertion, removal of the next event and cancellation are all O(log
+ * n). Each container records its current heap position in heap_index so that
+ * it can be removed from the middle of the heap. CALENDAR_EVENTLIST is a
+ * calendar queue (R. Brown, CACM 1988), i.e., an array of buckets ("days")
+ * each holding a short time ordered list, giving O(1) amortized insertion and
+ * removal. The number of buckets and the bucket width are adjusted
+ * automatically as the number of pending events changes. Events which are
+ * scheduled for the same time are executed in the order that they were
+ * scheduled in all cases.
+ *
+ * Every event list also keeps an index from event id to container, an open
+ * addressing hash table with linear probing, so that an event can be
+ * descheduled without searching for it.
+ */
+
+typedef enum {LINKED_EVENTLIST, HEAP_EVENTLIST, CALENDAR_EVENTLIST}
+  Eventlist_Type;
+
+#define EVENTLIST_HEAP_ARITY 4
+#define CALENDAR_MIN_BUCKETS 2
+#define CALENDAR_MAX_SAMPLES 25
+#define EVENTLIST_INDEX_MIN_SIZE 16
+
+#ifndef DEFAULT_EVENTLIST
+#define DEFAULT_EVENTLIST HEAP_EVENTLIST
+#endif
+
+typedef struct _calendar_bucket_
+{
+  struct _event_container_ * front_ptr;
+  struct _event_container_ * back_ptr;
+} Calendar_Bucket, * Calendar_Bucket_Ptr;
+
 typedef struct _eventlist_
 {
+  Eventlist_Type type;
   struct _event_container_ * front_ptr;
   struct _event_container_ * back_ptr;
+  struct _event_container_ ** heap;
+  long int heap_capacity;
+  struct _calendar_bucket_ * calendar;
+  long int calendar_buckets;
+  double calendar_width;
+  long long calendar_day;
+  double calendar_last_time;
+  struct _event_container_ ** index;
+  long int index_capacity;
+  int index_bits;
   int size;
 } Eventlist, * Eventlist_Ptr;
 
 /******************************************************************************/
 
 /*
- * FIFO queue object keeps the queue size and contains pointers to containers
- * at the front and back of the queue. The queue container objects are kept on
- * a singly linked list. Each container has a content pointer that tracks the
- * object placed on the FIFO queue.
+ * FIFO queue object keeps the queue size and a ring buffer holding the content
+ * pointers of the objects placed on the FIFO queue. The ring has capacity
+ * slots (always a power of two) and the front of the queue is at slot
+ * front. The ring doubles in size when it fills up. If shrink is set, it is
+ * halved again whenever the queue falls to a quarter of its capacity, so that
+ * the memory used by a large backlog is returned once it drains.
  */
 
-struct _queue_container_;
+#define FIFOQUEUE_MIN_CAPACITY 8
 
 typedef struct _fifoqueue_
 {
-  struct _queue_container_ * front_ptr;
-  struct _queue_container_ * back_ptr;
+  void ** ring;
+  long int capacity;
+  long int front;
+  int shrink;
   long int size;
 } Fifoqueue, * Fifoqueue_Ptr;
 
-typedef struct _queue_container_
+/*
+ * Intrusive FIFO queue. Objects which are only ever on one queue at a time
+ * can embed a Queue_Link in their own struct and be placed on a Linkqueue
+ * directly, so that no container has to be allocated for them. The queue
+ * returns the link, and LINKQUEUE_OWNER gives back the object that contains
+ * it, e.g.,
+ *
+ *   packet = LINKQUEUE_OWNER(linkqueue_get(buffer), Packet, queue_link);
+ *
+ * The links are doubly linked, so an object can also be taken out of the
+ * middle of the queue in O(1) with linkqueue_remove, e.g., a customer that
+ * gives up waiting.
+ */
+
+typedef struct _queue_link_
+{
+  struct _queue_link_ * next_link;
+  struct _queue_link_ * previous_link;
+} Queue_Link, * Queue_Link_Ptr;
+
+typedef struct _linkqueue_
+{
+  struct _queue_link_ * front_ptr;
+  struct _queue_link_ * back_ptr;
+  int size;
+} Linkqueue, * Linkqueue_Ptr;
+
+#define LINKQUEUE_OWNER(link_ptr, type, member) \
+  ((type *) ((char *) (link_ptr) - offsetof(type, member)))
+
+/*
+ * Object pool. A Pool hands out fixed size objects (e.g., packets) carved from
+ * pages of POOL_PAGE_OBJECTS objects, and objects given back with pool_put are
+ * kept on a free list for reuse instead of being freed. Once a run reaches its
+ * largest number of live objects, getting and putting them does no memory
+ * allocation. A Pool is meant to be owned by one simulation_run and is not
+ * locked, so each run (or thread) should have its own. Freeing the Pool
+ * releases every object it handed out. A Pool made by simulation_run_pool_new
+ * takes its pages from the run arena instead and is released with the run.
+ */
+
+#define POOL_PAGE_OBJECTS 256
+#define POOL_ALIGNMENT 16
+
+typedef struct _pool_page_
+{
+  struct _pool_page_ * next_page;
+} Pool_Page, * Pool_Page_Ptr;
+
+typedef struct _pool_
 {
-  void * content_ptr;
-  struct _queue_container_ * next_ptr;
-} Queue_Container, *Queue_Container_Ptr;
+  unsigned long object_size;
+  void * free_list;
+  struct _pool_page_ * pages;
+  struct _arena_ * arena;
+  long int page_count;
+  long int objects_in_use;
+} Pool, * Pool_Ptr;
 
 /******************************************************************************/
 
@@ -128,31 +302,287 @@ typedef struct _server_
   void * customer_in_service;
 } Server, * Server_Ptr;
 
+/*
+ * A Server_Pool is a group of identical servers, e.g., the channels of a
+ * trunk group. The servers are kept in one array and the indices of the idle
+ * ones are kept on a stack, so that finding an idle server and giving it back
+ * are O(1) however large the pool is. A server taken with server_pool_acquire
+ * is still FREE; it is used with server_put/server_get as usual and handed
+ * back with server_pool_release once it is FREE again.
+ */
+
+typedef struct _server_pool_
+{
+  struct _server_ * servers;
+  int * idle_stack;
+  int number_of_servers;
+  int number_idle;
+} Server_Pool, * Server_Pool_Ptr;
+
 /******************************************************************************/
 
 /*
- * Random Number Generation
+ * Slotted Time
+ *
+ * A Slot_Clock divides time into slots of slot_duration, numbered 0, 1, 2,
+ * ... from time 0, and keeps a bucket of items, e.g., packets about to
+ * transmit, for each slot. Items are placed by integer slot number, and slot
+ * s starts exactly at s * slot_duration, so there is no need to nudge event
+ * times by a small epsilon to get them in order at a slot boundary.
  *
- * The generator uses the library function rand() which must return an int
- * within the range 1 to RAND_MAX.  Note: RAND_MAX is defined for this purpose
- * in ANSI C.)
+ * When the first item is added to a slot, one event is scheduled for the
+ * start of that slot. The event calls the clock's resolve function once, and
+ * it takes every item out of the bucket and deals with them together, e.g.,
+ * deciding from their number whether the slot is idle, a success or a
+ * collision. Slots with no items cost nothing, and an item moved to a later
+ * slot only needs an event if that slot had none.
+ *
+ * The buckets are a ring indexed by slot number, which doubles whenever an
+ * item is added further ahead than it reaches.
  */
 
+#define SLOT_CLOCK_MIN_BUCKETS 16
+
+typedef struct _slot_clock_
+{
+  struct _simulation_run_ * simulation_run;
+  void (* resolve)(struct _simulation_run_ *, struct _slot_clock_ *, long int);
+  double slot_duration;
+  long int current_slot;
+  struct _fifoqueue_ ** buckets;
+  long int * bucket_slot;
+  long int number_of_buckets;
+} Slot_Clock, * Slot_Clock_Ptr;
+
+typedef void (* Slot_Function)(Simulation_Run_Ptr, Slot_Clock_Ptr, long int);
+
+/******************************************************************************/
+
 /*
- * _rand_stream_ permits having multiple rand() streams at once. Multiple
- * Rand_Stream objects can be created and accessed via rand_stream_get.
+ * Random Number Generation
+ *
+ * Random numbers come from xoshiro256++ (Blackman and Vigna), a 64-bit
+ * generator with a period of 2^256 - 1 and 256 bits of state. A Rand_Stream
+ * holds one such generator, so multiple independent streams (and seeds) can
+ * be used at once. Every simulation_run owns a stream, which event functions
+ * draw from with simulation_run_uniform_generator and
+ * simulation_run_exponential_generator. uniform_generator and
+ * exponential_generator draw from a single global stream, seeded by
+ * random_generator_initialize, and are only safe when one run is executed at a
+ * time.
+ *
+ * Uniform variates carry 52 random bits: they are (k + 1/2) 2^-52 for k =
+ * 0 .. 2^52 - 1, spaced 2^-52 apart. This is deliberate. Every such value is
+ * exactly representable and lies strictly inside (0, 1), so no branch or
+ * rejection is needed, and the block and per-call forms give the same
+ * numbers. With 53 bits, k 2^-53 would include 0, and (k + 1/2) 2^-53 is not
+ * representable above 1/2 and can round to 1.
+ *
+ * The sequence of a stream is split into substreams of 2^128 numbers each,
+ * far more than any run can use, so substreams never overlap. rand_stream_jump
+ * moves a stream ahead by any number of whole substreams in O(log n) time by
+ * computing the jump as a polynomial modulo the characteristic polynomial of
+ * the generator. This lets each of many parallel replications be handed its
+ * own substream of a single seed.
  */
 
 typedef struct _rand_stream_
 {
   unsigned seed;
-  unsigned rand_max;
-  unsigned next;
+  uint64_t state[4];
 } Rand_Stream, * Rand_Stream_Ptr;
 
-/* #ifndef RAND_MAX
- * #define RAND_MAX 2147483647.0
- * #endif */
+/******************************************************************************/
+
+/*
+ * Output Analysis
+ *
+ * A Batch_Means collects the observations of one statistic, e.g., the delay
+ * of each packet, and estimates a confidence interval for its mean by the
+ * method of batch means. Consecutive observations are grouped into batches
+ * long enough that the batch means are nearly independent, and the spread of
+ * the batch means gives the half-width of the interval. At most
+ * BATCH_MEANS_MAX_BATCHES batches are kept. When they are all full,
+ * neighbouring batches are merged and the batch size doubles, so the batches
+ * keep growing with the run and their correlation keeps falling.
+ *
+ * The half-width is for a 95% confidence interval and is only
+ * available once BATCH_MEANS_MIN_BATCHES batches are complete. It is updated
+ * each time a batch completes, so batch_means_converged is cheap enough to be
+ * tested after every event. That lets a run stop as soon as its estimate is
+ * precise enough instead of after a fixed number of observations.
+ *
+ * student_t_quantile gives the t quantile used for the interval. It can also
+ * be used for confidence intervals across independent replications.
+ */
+
+#define BATCH_MEANS_MAX_BATCHES 64
+#define BATCH_MEANS_MIN_BATCHES 32
+
+typedef struct _batch_means_
+{
+  long int batch_size;
+  long int number_of_batches;
+  long int count_in_batch;
+  double batch_sum;
+  double batch_means[BATCH_MEANS_MAX_BATCHES];
+  long int count;
+  double sum;
+  double half_width;
+} Batch_Means, * Batch_Means_Ptr;
+
+/******************************************************************************/
+
+/*
+ * Warm-up Detection
+ *
+ * Every run starts from an empty system, so the first observations of a
+ * steady state statistic are biased. A Warmup_Detector finds the end of this
+ * warm-up period online with the MSER-5 rule. Observations are averaged in
+ * batches of MSER_BATCH_SIZE, and for each candidate truncation point d the
+ * batch means Z_(d+1) .. Z_n give
+ *
+ *   MSER(d) = sum (Z_i - mean)^2 / (n - d)^2
+ *
+ * The truncation point is the d in the first half of the data that minimises
+ * MSER(d). It is accepted only if it lies strictly inside the first half, as
+ * otherwise the warm-up may not yet be over. The test is repeated each time
+ * the number of batches grows by an eighth, starting from WARMUP_MIN_BATCHES,
+ * which keeps the total cost linear in the number of observations.
+ *
+ * warmup_detector_add returns true once, when the warm-up is found to be over.
+ * Since MSER-5 can only accept a truncation point d after 2d batches, this
+ * comes at most about twice the warm-up length into the run, and the
+ * observations after the truncation point are already steady state. The
+ * caller then rolls its statistics back to the truncation point instead of
+ * discarding everything seen so far: warmup_detector_truncation_point gives
+ * the number of observations to drop and warmup_detector_truncated_sum their
+ * sum, which the detector keeps per batch until then. After that the
+ * detector ignores any further observations.
+ */
+
+#define MSER_BATCH_SIZE 5
+#define WARMUP_MIN_BATCHES 1000
+
+typedef struct _warmup_detector_
+{
+  double * batch_sums;
+  long int number_of_batches;
+  long int capacity;
+  double batch_sum;
+  int count_in_batch;
+  long int next_test;
+  long int truncation_point;
+  double truncated_sum;
+  long int count;
+} Warmup_Detector, * Warmup_Detector_Ptr;
+
+/******************************************************************************/
+
+/*
+ * Instability Detection
+ *
+ * When the offered load of a queue is at or above its capacity, its length
+ * and delays grow without bound and a long run only wastes time. A
+ * Drift_Detector watches such a statistic online. Observations are averaged
+ * in batches, and each window of DRIFT_WINDOW batch means gets a least squares
+ * line fitted to it. A window shows drift if its slope is positive at the 95%
+ * level (t test on the slope) and the line rises by at least DRIFT_MIN_RISE
+ * times the window mean. DRIFT_CONFIRMATIONS windows in a row must show drift
+ * before the statistic is declared unstable. The growth of an unstable queue
+ * is linear, so the slope of the last of these windows must also be at least
+ * DRIFT_SLOPE_RATIO times that of the first. The warm-up of a stable queue
+ * starting empty can rise for a long time too, but it levels off.
+ *
+ * A stable queue near saturation has long, slowly varying excursions that can
+ * look like a trend over a short window. So each window that shows no drift
+ * doubles the batch size, and the windows grow until they are long compared
+ * with these excursions. A truly unstable statistic keeps rising at every
+ * scale.
+ *
+ * drift_detector_add returns true once, when the statistic is found to be
+ * unstable. After that the detector ignores any further observations.
+ */
+
+#define DRIFT_WINDOW 32
+#define DRIFT_CONFIRMATIONS 4
+#define DRIFT_MIN_RISE 0.05
+#define DRIFT_SLOPE_RATIO 0.5
+
+typedef struct _drift_detector_
+{
+  double window[DRIFT_WINDOW];
+  int number_of_batches;
+  long int batch_size;
+  long int count_in_batch;
+  double batch_sum;
+  int confirmations;
+  int unstable;
+  double slope;
+  double first_slope;
+  long int count;
+} Drift_Detector, * Drift_Detector_Ptr;
+
+/******************************************************************************/
+
+/*
+ * Parameter Sweeps
+ *
+ * sweep_run executes every cell of a parameter grid, each cell normally being
+ * one independent simulation_run, on a pool of threads. The grid is an array
+ * of cells whose type is defined by the caller. A cell holds the parameters
+ * of one run and the space for its results. run_cell is called once for each
+ * cell and fills in its results. Every run has its own random stream and event
+ * ids, and writes only into its own cell. The table of results is therefore
+ * the same however many threads are used and in whatever order the cells
+ * complete.
+ *
+ * Grid cells can differ greatly in run time, so the threads balance the load
+ * by work stealing. The cells are dealt out to per-thread deques. Each thread
+ * runs cells from the back of its own deque, and once that is empty it steals
+ * from the front of the others. On _WIN32 the cells are run one after
+ * another in the calling thread.
+ */
+
+typedef void (* Sweep_Cell_Function)(void *);
+
+/******************************************************************************/
+
+/*
+ * Time-Parallel Queue Recursions
+ *
+ * The departure times of a FIFO single server queue follow
+ *
+ *   D(n) = max(A(n), D(n-1)) + S(n)
+ *
+ * which is linear in max-plus algebra, so a long sequence of customers can
+ * be split into chunks that are worked on in parallel. maxplus_departures
+ * does this for arrival and service times that have already been generated.
+ * First every chunk runs the recursion on its own threads as if the queue
+ * were empty at its start. Then the chunks are visited in order, and each is
+ * recomputed from its true starting departure time only until the two agree.
+ * That happens at the chunk's first idle period, after which both carry out
+ * exactly the same operations. The result is therefore identical, bit for
+ * bit, to the sequential recursion, and the sequential part is only as long
+ * as the busy periods that straddle chunk boundaries.
+ *
+ * This is not a max-plus prefix scan, and how well it scales depends on the
+ * load. Near saturation a busy period can span whole chunks, and they are
+ * then redone one after another. For an M/D/1 queue in segments of 2^20
+ * customers, the part of the customers redone sequentially was 0.3% with 4
+ * threads and 1.2% with 16 at rho = 0.95, 8% and 25% at rho = 0.99, and 78%
+ * and 88% at rho = 0.999, where the run is in effect sequential. Composing
+ * per-chunk (offset, last departure) summaries with a prefix scan would bound
+ * the sequential part by the number of chunks. It would also add up the
+ * service times of a busy period in a different order, though, so the
+ * results would no longer match the sequential recursion exactly.
+ *
+ * In a tandem line of FIFO queues the departures from one station are the
+ * arrivals to the next, and maxplus_tandem_departures applies the same method
+ * station by station.
+ */
+
+#define MAXPLUS_CHUNKS_PER_THREAD 4
 
 /******************************************************************************/
 
@@ -163,6 +593,9 @@ typedef struct _rand_stream_
 Simulation_Run_Ptr
 simulation_run_new(void);
 
+Simulation_Run_Ptr
+simulation_run_new_with_eventlist(Eventlist_Type);
+
 void
 simulation_run_execute_event(Simulation_Run_Ptr);
 
@@ -184,6 +617,33 @@ simulation_run_schedule_event(Simulation_Run_Ptr, Event, double);
 void *
 simulation_run_deschedule_event(Simulation_Run_Ptr, long int);
 
+long int
+simulation_run_events_allocated(Simulation_Run_Ptr);
+
+long int
+simulation_run_event_pages(Simulation_Run_Ptr);
+
+void *
+simulation_run_alloc(Simulation_Run_Ptr, unsigned long);
+
+void
+simulation_run_set_huge_pages(Simulation_Run_Ptr, int);
+
+unsigned long
+simulation_run_arena_size(Simulation_Run_Ptr);
+
+void
+simulation_run_random_generator_initialize(Simulation_Run_Ptr, unsigned);
+
+Rand_Stream_Ptr
+simulation_run_rand_stream(Simulation_Run_Ptr);
+
+double
+simulation_run_uniform_generator(Simulation_Run_Ptr);
+
+double
+simulation_run_exponential_generator(Simulation_Run_Ptr, double);
+
 Fifoqueue_Ptr
 fifoqueue_new(void);
 
@@ -199,6 +659,48 @@ fifoqueue_size(Fifoqueue_Ptr);
 void *
 fifoqueue_see_front(Fifoqueue_Ptr);
 
+void
+fifoqueue_set_shrink(Fifoqueue_Ptr, int);
+
+void
+fifoqueue_free(Fifoqueue_Ptr);
+
+Linkqueue_Ptr
+linkqueue_new(void);
+
+void
+linkqueue_put(Linkqueue_Ptr, Queue_Link_Ptr);
+
+Queue_Link_Ptr
+linkqueue_get(Linkqueue_Ptr);
+
+int
+linkqueue_size(Linkqueue_Ptr);
+
+Queue_Link_Ptr
+linkqueue_see_front(Linkqueue_Ptr);
+
+void
+linkqueue_remove(Linkqueue_Ptr, Queue_Link_Ptr);
+
+void
+linkqueue_free(Linkqueue_Ptr);
+
+Pool_Ptr
+pool_new(unsigned long);
+
+void *
+pool_get(Pool_Ptr);
+
+void
+pool_put(Pool_Ptr, void *);
+
+void
+pool_free(Pool_Ptr);
+
+Pool_Ptr
+simulation_run_pool_new(Simulation_Run_Ptr, unsigned long);
+
 Server_Ptr
 server_new(void);
 
@@ -211,6 +713,45 @@ server_get(Server_Ptr);
 Server_State
 server_state(Server_Ptr);
 
+Server_Pool_Ptr
+server_pool_new(int);
+
+Server_Ptr
+server_pool_acquire(Server_Pool_Ptr);
+
+void
+server_pool_release(Server_Pool_Ptr, Server_Ptr);
+
+int
+server_pool_busy_count(Server_Pool_Ptr);
+
+Server_Ptr
+server_pool_server(Server_Pool_Ptr, int);
+
+void
+server_pool_free(Server_Pool_Ptr);
+
+Slot_Clock_Ptr
+slot_clock_new(Simulation_Run_Ptr, double, Slot_Function);
+
+long int
+slot_clock_next_slot(Slot_Clock_Ptr, double);
+
+double
+slot_clock_slot_time(Slot_Clock_Ptr, long int);
+
+void
+slot_clock_add(Slot_Clock_Ptr, long int, void *);
+
+int
+slot_clock_count(Slot_Clock_Ptr, long int);
+
+void *
+slot_clock_get(Slot_Clock_Ptr, long int);
+
+void
+slot_clock_free(Slot_Clock_Ptr);
+
 double
 exponential_generator(double);
 
@@ -223,7 +764,7 @@ random_generator_initialize(unsigned);
 Rand_Stream_Ptr
 rand_stream_new(unsigned);
 
-unsigned
+uint64_t
 rand_stream_get(Rand_Stream_Ptr);
 
 void
@@ -235,12 +776,107 @@ rand_stream_uniform_generator(Rand_Stream_Ptr);
 double
 rand_stream_exponential_generator(Rand_Stream_Ptr, double);
 
+void
+rand_stream_uniform_block(Rand_Stream_Ptr, double *, long int);
+
+void
+rand_stream_exponential_block(Rand_Stream_Ptr, double, double *, long int);
+
+void
+rand_stream_jump(Rand_Stream_Ptr, unsigned long);
+
+Rand_Stream_Ptr
+rand_stream_new_substream(unsigned, unsigned long);
+
+double
+student_t_quantile(long int);
+
+Batch_Means_Ptr
+batch_means_new(long int);
+
+void
+batch_means_add(Batch_Means_Ptr, double);
+
+long int
+batch_means_count(Batch_Means_Ptr);
+
+double
+batch_means_mean(Batch_Means_Ptr);
+
+double
+batch_means_half_width(Batch_Means_Ptr);
+
+int
+batch_means_converged(Batch_Means_Ptr, double);
+
+void
+batch_means_reset(Batch_Means_Ptr, long int);
+
+void
+batch_means_free(Batch_Means_Ptr);
+
+Warmup_Detector_Ptr
+warmup_detector_new(void);
+
+int
+warmup_detector_add(Warmup_Detector_Ptr, double);
+
+int
+warmup_detector_done(Warmup_Detector_Ptr);
+
+long int
+warmup_detector_truncation_point(Warmup_Detector_Ptr);
+
+double
+warmup_detector_truncated_sum(Warmup_Detector_Ptr);
+
+long int
+warmup_detector_count(Warmup_Detector_Ptr);
+
+void
+warmup_detector_free(Warmup_Detector_Ptr);
+
+Drift_Detector_Ptr
+drift_detector_new(long int);
+
+int
+drift_detector_add(Drift_Detector_Ptr, double);
+
+int
+drift_detector_unstable(Drift_Detector_Ptr);
+
+double
+drift_detector_slope(Drift_Detector_Ptr);
+
+long int
+drift_detector_count(Drift_Detector_Ptr);
+
+void
+drift_detector_free(Drift_Detector_Ptr);
+
+int
+sweep_thread_count(void);
+
+void
+sweep_run(void *, long int, unsigned long, Sweep_Cell_Function, int);
+
+double
+maxplus_departures(const double *, const double *, double *, long int, double,
+		   int);
+
+void
+maxplus_tandem_departures(const double *, double **, double **, int, long int,
+			  double *, int);
+
 void *
 xmalloc(unsigned);
 
 void *
 xcalloc(unsigned, unsigned);
 
+void *
+xrealloc(void*, unsigned long);
+
 void
 xfree(void*);
 
@@ -33,6 +33,8 @@
 #define List_ARRIVALRATE 3              /* calls/minute */
 #define MEAN_CALL_DURATION 2, 4, 6, 8, 10   /* minutes */ //DONT CHANGE
 #define RUNLENGTH 5e6                   /* number of successful calls */
+#define RELATIVE_PRECISION 0.01         /* stop at this 95% CI half-width/mean, 0 = off */
+#define BATCH_SIZE 1000                 /* initial batch size for the blocking CI */
 #define BLIPRATE 1e3
 #define LIST_NUMBER_OF_CHANNELS 6, 8, 10, 12, 14
 #define t 5
@@ -42,6 +44,18 @@
 /* Comma separated list of random seeds to run. */
 #define RANDOM_SEED_LIST 400167784
 
+/* Simulate only the number of calls present (call_ctmc.h) instead of events. */
+#define USE_CTMC_ENGINE 0
+
+/*
+ * Calls, patience and arrivals are all exponential, so the Erlang-A results
+ * (erlang.h) are exact. Set this to print them without simulating.
+ */
+#define SKIP_EXACT_CELLS 0
+
+/* Threads used to run the parameter grid. 0 uses one per processor. */
+#define NUMBER_OF_THREADS 0
+
 /*******************************************************************************/
 
 #endif /* simparameters.h */
@@ -43,6 +43,7 @@ channel_new()
   new_channel = (Channel_Ptr) xmalloc(sizeof(Channel));
   set_channel_state(new_channel, IDLE);
   reset_transmitting_stn_count(new_channel);
+  new_channel->free_slot = 0;
   return new_channel;
 }
 
@@ -43,6 +43,7 @@ typedef struct _channel_
   int transmitting_stn_count;
   double arrive_time;
   double service_time;
+  long int free_slot;
 } Channel, * Channel_Ptr;
 
 /**********************************************************************/
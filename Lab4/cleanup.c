@@ -37,23 +37,24 @@ cleanup (Simulation_Run_Ptr simulation_run)
 
   data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
 
-  /* Clean out the stations. */
+  /*
+   * The packets come from the run pool and are released along with the
+   * simulation_run, so only the buffers themselves need to be freed here.
+   */
   for(i=0; i<NUMBER_OF_STATIONS; i++) {
-    while (fifoqueue_size((data->stations+i)->buffer) > 0) {
-      xfree(fifoqueue_get((data->stations+i)->buffer));
-    }
+    linkqueue_free((data->stations+i)->buffer);
   }
-
-  while(fifoqueue_size(data->buffer) > 0){
-    xfree(fifoqueue_get(data->buffer));
-  }
-  xfree(data->buffer);
+  fifoqueue_free(data->buffer);
+  batch_means_free(data->delay_statistics);
+  warmup_detector_free(data->warmup);
+  if(data->warmup_records != NULL) xfree(data->warmup_records);
 
   xfree(data->stations);
 
   /* Clean out the channel. */
   xfree(data->channel);
   xfree(data->data_channel);
+  slot_clock_free(data->reservation_slots);
 
   /* Clean up the simulation_run. */
   simulation_run_free_memory(simulation_run);
@@ -52,13 +52,13 @@ main(void)
   /* Do a new simulation_run for each random number generator seed. */
   while ((random_seed = RANDOM_SEEDS[j++]) != 0) {
     while((arrival_rate = arrival_rates[k++]) != 0){
-        /* Set the random generator seed. */
-        random_generator_initialize(random_seed);
-
         /* Create a new simulation_run. This gives a clock and
            eventlist. Clock time is set to zero. */
         simulation_run = (Simulation_Run_Ptr) simulation_run_new();
 
+        /* Set the random generator seed of the run. */
+        simulation_run_random_generator_initialize(simulation_run, random_seed);
+
         /* Add our data definitions to the simulation_run. */
         simulation_run_set_data(simulation_run, (void *) & data);
 
@@ -66,6 +66,8 @@ main(void)
         data.stations = (Station_Ptr) xcalloc((unsigned int) NUMBER_OF_STATIONS,
                           sizeof(Station));
         data.buffer = fifoqueue_new();
+        data.packet_pool = simulation_run_pool_new(simulation_run,
+                                                   sizeof(Packet));
 
         /* Initialize various simulation_run variables. */
         data.blip_counter = 0;
@@ -73,13 +75,19 @@ main(void)
         data.number_of_packets_processed = 0;
         data.number_of_collisions = 0;
         data.accumulated_delay = 0.0;
+        data.delay_statistics = batch_means_new(BATCH_SIZE);
+        data.warmup = warmup_detector_new();
+        data.warmup_record_count = 0;
+        data.warmup_record_capacity = WARMUP_MIN_BATCHES * MSER_BATCH_SIZE;
+        data.warmup_records = (Warmup_Record_Ptr)
+          xmalloc(data.warmup_record_capacity * sizeof(Warmup_Record));
         data.arrival_rate = arrival_rate;
         data.random_seed = random_seed;
 
         /* Initialize the stations. */
         for(i=0; i<NUMBER_OF_STATIONS; i++) {
           (data.stations+i)->id = i;
-          (data.stations+i)->buffer = fifoqueue_new();
+          (data.stations+i)->buffer = linkqueue_new();
           (data.stations+i)->packet_count = 0;
           (data.stations+i)->accumulated_delay = 0.0;
           (data.stations+i)->mean_delay = 0;
@@ -88,14 +96,19 @@ main(void)
         /* Create and initialize the channel. */
         data.channel = channel_new();
         data.data_channel = channel_new();
+        data.reservation_slots = slot_clock_new(simulation_run,
+                                                MEAN_SLOT_DURATION,
+                                                resolve_reservation_slot);
 
         /* Schedule initial packet arrival. */
         schedule_packet_arrival_event(simulation_run,
                 simulation_run_get_time(simulation_run) +
-                exponential_generator((double) 1/data.arrival_rate));
+                simulation_run_exponential_generator(simulation_run, (double) 1/data.arrival_rate));
 
-        /* Execute events until we are finished. */
-        while(data.number_of_packets_processed < RUNLENGTH) {
+        /* Execute events until the mean delay is known precisely enough, or
+           RUNLENGTH packets have been sent. */
+        while(data.number_of_packets_processed < RUNLENGTH &&
+              !batch_means_converged(data.delay_statistics, RELATIVE_PRECISION)) {
             simulation_run_execute_event(simulation_run);
         }
 
@@ -37,7 +37,7 @@
 /**********************************************************************/
 
 typedef double Time;
-typedef Fifoqueue_Ptr Buffer_Ptr;
+typedef Linkqueue_Ptr Buffer_Ptr;
 
 /**********************************************************************/
 
@@ -56,6 +56,7 @@ typedef enum {WAITING, TRANSMITTING} Packet_Status;
 
 typedef struct _packet_
 {
+  Queue_Link queue_link;
   double arrive_time;
   double service_time;
   int station_id;
@@ -63,12 +64,32 @@ typedef struct _packet_
   int collision_count;
 } Packet, * Packet_Ptr;
 
+/*
+ * What is collected for each delivered packet. These are kept until the end
+ * of the warm-up is found, so that the statistics can be rebuilt from the
+ * truncation point on.
+ */
+
+typedef struct _warmup_record_
+{
+  int station_id;
+  int collision_count;
+  double delay;
+} Warmup_Record, * Warmup_Record_Ptr;
+
 typedef struct _simulation_run_data_
 {
   Station_Ptr stations;
   Channel_Ptr channel;
   Channel_Ptr data_channel;
-  Buffer_Ptr buffer;
+  Slot_Clock_Ptr reservation_slots;
+  Fifoqueue_Ptr buffer;
+  Pool_Ptr packet_pool;
+  Batch_Means_Ptr delay_statistics;
+  Warmup_Detector_Ptr warmup;
+  Warmup_Record_Ptr warmup_records;
+  long int warmup_record_count;
+  long int warmup_record_capacity;
 
   long int blip_counter;
   long int arrival_count;
@@ -78,11 +78,20 @@ void output_results(Simulation_Run_Ptr this_simulation_run)
   printf("Xmtted Pkts  = %ld (Service Fraction = %.5f)\n",
 	 sim_data->number_of_packets_processed, xmtted_fraction);
 
+  if(warmup_detector_done(sim_data->warmup)) {
+    printf("Warm-up Pkts = %ld (MSER-5 truncation point, found after %ld)\n",
+	   warmup_detector_truncation_point(sim_data->warmup),
+	   warmup_detector_count(sim_data->warmup));
+  } else {
+    printf("Warm-up Pkts = (end of warm-up not detected)\n");
+  }
+
   printf("Arrival Rate   = %.3f \n",
 	 sim_data->arrival_rate);
 
-  printf("Mean Delay   = %.1f \n",
-	 sim_data->accumulated_delay/sim_data->number_of_packets_processed);
+  printf("Mean Delay   = %.1f (95%% CI +/- %.2f)\n",
+	 sim_data->accumulated_delay/sim_data->number_of_packets_processed,
+	 batch_means_half_width(sim_data->delay_statistics));
 
   printf("Mean collisions per packet = %.3f\n",
 	 (double) sim_data->number_of_collisions /
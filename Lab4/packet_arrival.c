@@ -63,10 +63,10 @@ packet_arrival_event(Simulation_Run_Ptr simulation_run, void* dummy_ptr)
     /* Randomly pick the station that this packet is arriving to. Note
      that randomly splitting a Poisson process creates multiple
      independent Poisson processes.*/
-    random_station_id = (int) floor(uniform_generator()*NUMBER_OF_STATIONS);
+    random_station_id = (int) floor(simulation_run_uniform_generator(simulation_run)*NUMBER_OF_STATIONS);
     station = data->stations + random_station_id;
 
-    new_packet = (Packet_Ptr) xmalloc(sizeof(Packet));
+    new_packet = (Packet_Ptr) pool_get(data->packet_pool);
     new_packet->arrive_time = now;
     new_packet->service_time = get_packet_duration();
     new_packet->status = WAITING;
@@ -75,18 +75,24 @@ packet_arrival_event(Simulation_Run_Ptr simulation_run, void* dummy_ptr)
 
     /* Put the packet in the buffer at that station. */
     stn_buffer = station->buffer;
-    fifoqueue_put(stn_buffer, (void *) new_packet);
+    linkqueue_put(stn_buffer, &new_packet->queue_link);
 
     /* If this is the only packet at the station, transmit it (i.e., the
      ALOHA protocol). It stays in the queue either way. */
-    if(fifoqueue_size(stn_buffer) == 1) {
-    /* Transmit the packet. */
-        schedule_transmission_start_event(simulation_run, now, (void *) new_packet);
+    if(linkqueue_size(stn_buffer) == 1) {
+    /* Transmit the packet, at the start of the next slot if time is slotted. */
+        if(USE_SLOTTED_TIME) {
+            slot_clock_add(data->reservation_slots,
+                           slot_clock_next_slot(data->reservation_slots, now),
+                           (void *) new_packet);
+        } else {
+            schedule_transmission_start_event(simulation_run, now, (void *) new_packet);
+        }
     }
 
     /* Schedule the next packet arrival. */
     schedule_packet_arrival_event(simulation_run,
-        now + exponential_generator((double) 1/data->arrival_rate));
+        now + simulation_run_exponential_generator(simulation_run, (double) 1/data->arrival_rate));
 }
 
 
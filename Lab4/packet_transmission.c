@@ -31,6 +31,57 @@
 
 /*******************************************************************************/
 
+/*
+ * Collect the statistics of one delivered packet.
+ */
+
+static void
+collect_statistics(Simulation_Run_Data_Ptr data, Warmup_Record_Ptr record)
+{
+    (data->stations+record->station_id)->packet_count++;
+    (data->stations+record->station_id)->accumulated_delay += record->delay;
+
+    data->number_of_collisions += record->collision_count;
+    data->accumulated_delay += record->delay;
+    batch_means_add(data->delay_statistics, record->delay);
+}
+
+/*
+ * At the end of the warm-up period, roll the statistics back to the MSER
+ * truncation point, so that the results only cover the steady state. They are
+ * cleared and the packets delivered since the truncation point are collected
+ * again. The arrivals are rolled back by the same number of packets.
+ */
+
+static void
+end_warmup(Simulation_Run_Data_Ptr data)
+{
+    long int i, truncation_point;
+
+    truncation_point = warmup_detector_truncation_point(data->warmup);
+
+    data->arrival_count -= truncation_point;
+    data->number_of_packets_processed -= truncation_point;
+    data->number_of_collisions = 0;
+    data->accumulated_delay = 0.0;
+    batch_means_reset(data->delay_statistics, BATCH_SIZE);
+
+    for(i=0; i<NUMBER_OF_STATIONS; i++) {
+        (data->stations+i)->packet_count = 0;
+        (data->stations+i)->accumulated_delay = 0.0;
+    }
+
+    for(i=truncation_point; i<data->warmup_record_count; i++) {
+        collect_statistics(data, data->warmup_records+i);
+    }
+
+    xfree(data->warmup_records);
+    data->warmup_records = NULL;
+    data->warmup_record_count = 0;
+}
+
+/*******************************************************************************/
+
 long int
 schedule_transmission_start_event(Simulation_Run_Ptr simulation_run,
 				  Time event_time,
@@ -136,12 +187,13 @@ transmission_end_event(Simulation_Run_Ptr simulation_run, void * packet)
                                       (void*) this_packet);
 
     // Take out the packet from the station buffer
-    fifoqueue_get(buffer);
+    linkqueue_get(buffer);
 
     /* See if there is another packet at this station. If so, enable
     it for transmission. We will transmit immediately. */
-    if(fifoqueue_size(buffer) > 0) {
-        next_packet = fifoqueue_see_front(buffer);
+    if(linkqueue_size(buffer) > 0) {
+        next_packet = LINKQUEUE_OWNER(linkqueue_see_front(buffer), Packet,
+                                      queue_link);
 
         schedule_transmission_start_event(simulation_run,
                     now + epsilon,
@@ -151,6 +203,82 @@ transmission_end_event(Simulation_Run_Ptr simulation_run, void * packet)
 
 /*******************************************************************************/
 
+/*
+ * Try to reserve the channel for this_packet in a slot. If the channel is
+ * free, the packet has it until the end of its transmission, and it is put in
+ * the bucket of the slot where that ends. Otherwise it is deferred to the slot
+ * where the channel is free again, which counts as a collision, as in
+ * transmission_start_event.
+ */
+
+static void
+reserve_slot(Slot_Clock_Ptr slots, Channel_Ptr channel, long int slot,
+             Packet_Ptr this_packet)
+{
+    if(slot >= channel->free_slot) {
+        this_packet->status = TRANSMITTING;
+        channel->free_slot =
+          slot_clock_next_slot(slots, slot_clock_slot_time(slots, slot) +
+                               this_packet->service_time);
+    } else {
+        this_packet->collision_count++;
+    }
+
+    slot_clock_add(slots, channel->free_slot, (void *) this_packet);
+}
+
+/*
+ * The slotted time form of transmission_start_event and
+ * transmission_end_event (USE_SLOTTED_TIME). It is called once for each slot
+ * in which anything happens on the reservation channel, with every packet
+ * that ends its reservation or tries to start one in that slot. A packet
+ * that ends goes on to the data channel, and the next packet at its station
+ * tries to start in the same slot. The first packet to try while the channel
+ * is free gets it, and the rest are deferred.
+ */
+
+void
+resolve_reservation_slot(Simulation_Run_Ptr simulation_run,
+                         Slot_Clock_Ptr slots, long int slot)
+{
+    Packet_Ptr this_packet, next_packet;
+    Buffer_Ptr buffer;
+    Time now;
+    Simulation_Run_Data_Ptr data;
+    int i, count;
+
+    data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
+    now = slot_clock_slot_time(slots, slot);
+    count = slot_clock_count(slots, slot);
+
+    for(i=0; i<count; i++) {
+        this_packet = (Packet_Ptr) slot_clock_get(slots, slot);
+
+        if(this_packet->status != TRANSMITTING) {
+            reserve_slot(slots, data->channel, slot, this_packet);
+            continue;
+        }
+
+        TRACE(printf("Success.\n"););
+
+        /* The reservation has ended. Send the packet on the data channel. */
+        schedule_transmission_queue_event(simulation_run,
+                                          now,
+                                          (void*) this_packet);
+
+        buffer = (data->stations+this_packet->station_id)->buffer;
+        linkqueue_get(buffer);
+
+        if(linkqueue_size(buffer) > 0) {
+            next_packet = LINKQUEUE_OWNER(linkqueue_see_front(buffer), Packet,
+                                          queue_link);
+            reserve_slot(slots, data->channel, slot, next_packet);
+        }
+    }
+}
+
+/*******************************************************************************/
+
 long int
 schedule_transmission_queue_event(Simulation_Run_Ptr simulation_run,
                                   Time event_time,
@@ -221,10 +349,11 @@ void
 transmission_queue_end_event(Simulation_Run_Ptr simulation_run, void * packet)
 {
     Packet_Ptr this_packet, next_packet;
-    Buffer_Ptr buffer;
+    Fifoqueue_Ptr buffer;
     Time now;
     Simulation_Run_Data_Ptr data;
     Channel_Ptr channel;
+    Warmup_Record record;
 
     data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
     channel = data->data_channel;
@@ -243,16 +372,30 @@ transmission_queue_end_event(Simulation_Run_Ptr simulation_run, void * packet)
     TRACE(printf("Success.\n"););
 
     /* Collect statistics. */
-    (data->stations+this_packet->station_id)->packet_count++;
-    (data->stations+this_packet->station_id)->accumulated_delay += now - this_packet->arrive_time;
-
-    data->number_of_collisions += this_packet->collision_count;
-    data->accumulated_delay += now - this_packet->arrive_time;
+    record.station_id = this_packet->station_id;
+    record.collision_count = this_packet->collision_count;
+    record.delay = now - this_packet->arrive_time;
+    collect_statistics(data, &record);
+
+    /* Keep the packet until the warm-up period is over. */
+    if(!warmup_detector_done(data->warmup)) {
+        if(data->warmup_record_count == data->warmup_record_capacity) {
+            data->warmup_record_capacity *= 2;
+            data->warmup_records = (Warmup_Record_Ptr)
+              xrealloc(data->warmup_records,
+                       data->warmup_record_capacity * sizeof(Warmup_Record));
+        }
+        data->warmup_records[data->warmup_record_count++] = record;
+
+        if(warmup_detector_add(data->warmup, record.delay)) {
+            end_warmup(data);
+        }
+    }
 
     output_blip_to_screen(simulation_run);
 
     /* This packet is done. */
-    free((void*) fifoqueue_get(buffer));
+    pool_put(data->packet_pool, fifoqueue_get(buffer));
 
     /* See if there is another packet at this station. If so, enable
     it for transmission. We will transmit immediately. */
@@ -47,6 +47,9 @@ transmission_end_event(Simulation_Run_Ptr, void *);
 long int
 schedule_transmission_end_event(Simulation_Run_Ptr, Time, void *);
 
+void
+resolve_reservation_slot(Simulation_Run_Ptr, Slot_Clock_Ptr, long int);
+
 void
 transmission_queue_event(Simulation_Run_Ptr, void *);
 
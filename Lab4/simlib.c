@@ -25,6 +25,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 #include "trace.h"
 #include "simlib.h"
@@ -43,7 +53,67 @@ static void
 simulation_run_set_time (Simulation_Run_Ptr, double);
 
 static Eventlist_Ptr
-eventlist_new(void);
+eventlist_new(Eventlist_Type);
+
+static void
+eventlist_insert(Eventlist_Ptr, Event_Container_Ptr);
+
+static Event_Container_Ptr
+eventlist_remove_front(Eventlist_Ptr);
+
+static Event_Container_Ptr
+eventlist_find(Eventlist_Ptr, long int);
+
+static void
+eventlist_remove(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+eventlist_free(Eventlist_Ptr);
+
+static void
+eventlist_index_insert(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+eventlist_index_remove(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+linked_eventlist_insert(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+linked_eventlist_remove(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+heap_eventlist_insert(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+heap_eventlist_remove(Eventlist_Ptr, Event_Container_Ptr);
+
+static Event_Container_Ptr
+calendar_eventlist_front(Eventlist_Ptr);
+
+static void
+calendar_eventlist_insert(Eventlist_Ptr, Event_Container_Ptr);
+
+static void
+calendar_eventlist_remove(Eventlist_Ptr, Event_Container_Ptr);
+
+static Arena_Ptr
+arena_new(void);
+
+static void *
+arena_alloc(Arena_Ptr, unsigned long);
+
+static void
+arena_free(Arena_Ptr);
+
+static Event_Slab_Ptr
+event_slab_new(Arena_Ptr);
+
+static Event_Container_Ptr
+event_slab_get(Event_Slab_Ptr);
+
+static void
+event_slab_put(Event_Slab_Ptr, Event_Container_Ptr);
 
 static Eventlist_Ptr
 simulation_run_get_eventlist(Simulation_Run_Ptr);
@@ -59,17 +129,34 @@ static void event_print_type(Event);
 
 /*
  * Create a new simulation_run. The simulation_run will include a clock, an
- * event list, and a data pointer to simulation_run data.
+ * event list, and a data pointer to simulation_run data. The event list is of
+ * the type given by DEFAULT_EVENTLIST (see simlib.h).
  */
 
 Simulation_Run_Ptr
 simulation_run_new(void)
+{
+  return simulation_run_new_with_eventlist(DEFAULT_EVENTLIST);
+}
+
+/*
+ * Create a new simulation_run whose event list is of the given type.
+ */
+
+Simulation_Run_Ptr
+simulation_run_new_with_eventlist(Eventlist_Type eventlist_type)
 {
   Simulation_Run_Ptr new_simulation_run;
 
   new_simulation_run = (Simulation_Run_Ptr) xmalloc(sizeof(Simulation_Run));
-  new_simulation_run->eventlist = eventlist_new();
+  new_simulation_run->eventlist = eventlist_new(eventlist_type);
   new_simulation_run->clock = clock_new();
+  new_simulation_run->arena = arena_new();
+  new_simulation_run->event_slab = event_slab_new(new_simulation_run->arena);
+  new_simulation_run->rand_stream = (Rand_Stream_Ptr)
+    arena_alloc(new_simulation_run->arena, sizeof(Rand_Stream));
+  rand_stream_initialize(new_simulation_run->rand_stream, 1);
+  new_simulation_run->next_event_id = 1;
   new_simulation_run->data = NULL;
   return new_simulation_run;
 }
@@ -135,19 +222,19 @@ simulation_run_set_data (Simulation_Run_Ptr this_simulation_run, void * data)
  * This function makes an entry on the event list. It must be passed the
  * simulation_run, the type of event, and the time that the event is to occur. An
  * event_contents pointer can also be passed which can be recovered when the
- * event function is called. The event list itself is a double linked list.
+ * event function is called. The returned event id can be used to deschedule
+ * the event.
  */
 
 long int
 simulation_run_schedule_event(Simulation_Run_Ptr simulation_run,
 			      Event new_event, double new_event_time)
 {
-  Event_Container_Ptr current_container, new_container,
-    next_container;
+  Event_Container_Ptr new_container;
 
   double current_time;
   Eventlist_Ptr event_list;
-  static long int event_id = 1;
+  long int event_id;
 
   current_time = simulation_run_get_time(simulation_run);
   event_list = simulation_run_get_eventlist(simulation_run);
@@ -175,56 +262,19 @@ simulation_run_schedule_event(Simulation_Run_Ptr simulation_run,
     exit(1);
   }
 
-  new_container = (Event_Container_Ptr) xmalloc(sizeof(Event_Container));
+  event_id = simulation_run->next_event_id++;
+
+  new_container = event_slab_get(simulation_run->event_slab);
   new_container->occurrence_time = new_event_time;
   new_container->event = new_event;
+  new_container->data_ptr = new_event.attachment;
   new_container->next_container = NULL;
   new_container->previous_container = NULL;
+  new_container->heap_index = -1;
   new_container->event_id = event_id;
 
-  if (event_list->size == 0) {
-    /* The list is empty. */
-    event_list->front_ptr = new_container;
-    event_list->back_ptr = new_container;
-    event_list->size++;
-    return event_id++;
-  }
-
-  if (event_list->front_ptr->occurrence_time > new_event_time) {
-    /* Add to front of the list. */
-    event_list->front_ptr->previous_container = new_container;
-    new_container->next_container = event_list->front_ptr;
-    event_list->front_ptr = new_container;
-
-    event_list->size++;
-    return event_id++;
-  }
-
-  if (event_list->back_ptr->occurrence_time <= new_event_time) {
-    /* Add to the back of the list. */
-    event_list->back_ptr->next_container = new_container;
-    new_container->previous_container = event_list->back_ptr;
-    event_list->back_ptr = new_container;
-
-    event_list->size++;
-    return event_id++;
-  }
-
-  /* Add to the middle of the list. */
-  current_container = event_list->front_ptr;
-  next_container = event_list->front_ptr->next_container;
-
-  while(next_container->occurrence_time <= new_event_time) {
-    current_container = next_container;
-    next_container = current_container->next_container;
-  }
-  current_container->next_container = new_container;
-  new_container->previous_container = current_container;
-  next_container->previous_container = new_container;
-  new_container->next_container = next_container;
-
-  event_list->size++;
-  return event_id++;
+  eventlist_insert(event_list, new_container);
+  return event_id;
 }
 
 /*
@@ -237,55 +287,23 @@ void *
 simulation_run_deschedule_event(Simulation_Run_Ptr simulation_run,
 				long int event_id)
 {
-  int i;
-  Event_Container_Ptr current_container, found_container=NULL,
-    next_container, previous_container;
+  Event_Container_Ptr found_container;
   void * content_ptr = NULL;
 
   Eventlist_Ptr event_list;
 
   event_list = simulation_run_get_eventlist(simulation_run);
 
-  current_container = event_list->front_ptr;
-  next_container = current_container->next_container;
-
-  for(i=0; i<event_list->size; i++) {
-
-    if(current_container->event_id == event_id) {
-
-      found_container = current_container;
-      previous_container = found_container->previous_container;
-      next_container = found_container->next_container;
+  if ((found_container = eventlist_find(event_list, event_id)) != NULL) {
 
-      /* Front of list. Adjust the front pointer. */
-      if (event_list->front_ptr == found_container)
-        event_list->front_ptr = next_container;
+    eventlist_remove(event_list, found_container);
+    content_ptr = found_container->data_ptr;
 
-      /* Back of list. Adjust the back pointer (could be both fron and
-	 back). */
-      if (event_list->back_ptr == found_container)
-        event_list->back_ptr = previous_container;
-
-      /* If the next event exists, adjust its previous event pointer. */
-      if (next_container != NULL)
-        next_container->previous_container = previous_container;
-
-      /* If the previous event exists, adjust its next event pointer. */
-      if (previous_container != NULL)
-        previous_container->next_container = next_container;
-
-      content_ptr = found_container->data_ptr;
-
-      TRACE(printf("At %.2f : ", simulation_run_get_time(simulation_run));)
-      TRACE(event_print_type(found_container->event);)
-      TRACE(printf("descheduled\n");)
-
-      free((void*) found_container);
-      event_list->size--;
-      break;
-    }
-    current_container = current_container->next_container;
+    TRACE(printf("At %.2f : ", simulation_run_get_time(simulation_run));)
+    TRACE(event_print_type(found_container->event);)
+    TRACE(printf("descheduled\n");)
 
+    event_slab_put(simulation_run->event_slab, found_container);
   }
   return content_ptr;
 }
@@ -300,7 +318,6 @@ static Event_Container_Ptr
 simulation_run_get_event(Simulation_Run_Ptr simulation_run)
 {
   Eventlist_Ptr event_list;
-  Event_Container_Ptr top_container;
 
   event_list = simulation_run_get_eventlist(simulation_run);
 
@@ -309,19 +326,7 @@ simulation_run_get_event(Simulation_Run_Ptr simulation_run)
     exit(1);
   }
 
-  top_container = event_list->front_ptr;
-
-  if (event_list->size == 1) {
-    event_list->front_ptr = NULL;
-    event_list->back_ptr = NULL;
-    event_list->size--;
-  } else {
-
-    top_container->next_container->previous_container = NULL;
-    event_list->front_ptr = top_container->next_container;
-    event_list->size--;
-  }
-  return (top_container);
+  return eventlist_remove_front(event_list);
 }
 
 /*
@@ -344,7 +349,7 @@ simulation_run_execute_event(Simulation_Run_Ptr simulation_run)
 
   (*(current_container->event.function))(simulation_run,
 			current_container->event.attachment);
-  xfree(current_container);
+  event_slab_put(simulation_run->event_slab, current_container);
 }
 
 /*
@@ -354,320 +359,2792 @@ simulation_run_execute_event(Simulation_Run_Ptr simulation_run)
 void
 simulation_run_free_memory(Simulation_Run_Ptr this_simulation_run)
 {
-  Eventlist_Ptr event_list;
-
-  /* Clean out the event list. */
-  event_list = this_simulation_run->eventlist;
-
-  while (event_list->size > 0) {
-    xfree((void*) simulation_run_get_event(this_simulation_run));
-  }
-
-  /* Clean up the simulation_run. */
-  xfree(this_simulation_run->eventlist);
+  /*
+   * The event containers still on the event list, along with everything else
+   * taken from the arena, go when the arena is released.
+   */
+  eventlist_free(this_simulation_run->eventlist);
+  arena_free(this_simulation_run->arena);
   xfree(this_simulation_run->clock);
   xfree(this_simulation_run);
 }
 
 /*
- * Functions for handling various event list operations.
- *
- * Create a new event list. This is called when a simulation_run is
- * created. The event list is included in the simulation_run.
+ * Event slab functions. Containers are handed out from the free list, which is
+ * refilled a page at a time from the run arena when it runs out.
  */
 
-static Eventlist_Ptr
-eventlist_new(void)
+static Event_Slab_Ptr
+event_slab_new(Arena_Ptr arena)
 {
-  Eventlist_Ptr new_event_list;
+  Event_Slab_Ptr new_slab;
+
+  new_slab = (Event_Slab_Ptr) arena_alloc(arena, sizeof(Event_Slab));
+  new_slab->free_list = NULL;
+  new_slab->arena = arena;
+  new_slab->page_count = 0;
+  new_slab->containers_in_use = 0;
+  new_slab->containers_allocated = 0;
+  return new_slab;
+}
 
-  new_event_list = (Eventlist_Ptr) xmalloc(sizeof(Eventlist));
+static Event_Container_Ptr
+event_slab_get(Event_Slab_Ptr slab)
+{
+  Event_Container_Ptr new_page, container;
+  int i;
 
-  new_event_list->front_ptr = NULL;
-  new_event_list->back_ptr = NULL;
-  new_event_list->size = 0;
-  return new_event_list;
+  if (slab->free_list == NULL) {
+    new_page = (Event_Container_Ptr)
+      arena_alloc(slab->arena, EVENT_SLAB_PAGE_SIZE * sizeof(Event_Container));
+    slab->page_count++;
+
+    for (i=EVENT_SLAB_PAGE_SIZE-1; i>=0; i--) {
+      new_page[i].next_container = slab->free_list;
+      slab->free_list = &(new_page[i]);
+    }
+  }
+
+  container = slab->free_list;
+  slab->free_list = container->next_container;
+  slab->containers_in_use++;
+  slab->containers_allocated++;
+  return container;
+}
+
+static void
+event_slab_put(Event_Slab_Ptr slab, Event_Container_Ptr container)
+{
+  container->next_container = slab->free_list;
+  slab->free_list = container;
+  slab->containers_in_use--;
 }
 
 /*
- * Get a pointer to the eventlist. This is intended for use only by simlib.
+ * Return the number of event containers that the simulation_run has handed out
+ * so far, i.e., the number of events scheduled.
  */
 
-static Eventlist_Ptr
-simulation_run_get_eventlist(Simulation_Run_Ptr simulation_run)
+long int
+simulation_run_events_allocated(Simulation_Run_Ptr simulation_run)
 {
-  return simulation_run->eventlist;
+  return simulation_run->event_slab->containers_allocated;
 }
 
 /*
- * Some functions that are only needed if trace is enabled.
+ * Return the number of slab pages taken from the run arena for event
+ * containers. This stops growing once the event list has reached its largest
+ * size.
  */
 
-#ifdef TRACE_ON
-
-static void
-event_print_type(Event event)
+long int
+simulation_run_event_pages(Simulation_Run_Ptr simulation_run)
 {
-  printf("%s ", event.description);
+  return simulation_run->event_slab->page_count;
 }
 
-#endif /* TRACE_ON */
-
 /*
- * FIFO queue functions
+ * Arena functions.
  *
- * Make a new (empty) FIFO queue. This will return a pointer to the created
- * Fifoqueue. The FIFO queue is a singly linked list.
+ * Create a new (empty) arena. No memory is taken until it is first used. Its
+ * blocks are backed by huge pages if ARENA_HUGE_PAGES is set.
  */
 
-Fifoqueue_Ptr
-fifoqueue_new(void)
+static Arena_Ptr
+arena_new(void)
 {
-  Fifoqueue_Ptr queue_id;
+  Arena_Ptr new_arena;
 
-  queue_id = (Fifoqueue_Ptr) xmalloc(sizeof(Fifoqueue));
-  queue_id->size = 0;
-  queue_id->front_ptr = NULL;
-  queue_id->back_ptr  = NULL;
-  return queue_id;
+  new_arena = (Arena_Ptr) xmalloc(sizeof(Arena));
+  new_arena->blocks = NULL;
+  new_arena->bytes_allocated = 0;
+  new_arena->use_huge_pages = ARENA_HUGE_PAGES;
+  return new_arena;
 }
 
 /*
- * Put something into a FIFO queue. Whatever it is should be cast to a void
- * pointer.
+ * Get a new block of (at least) the given size for the arena. When huge pages
+ * are asked for, the block is mapped with MAP_HUGETLB if the system has huge
+ * pages reserved, and otherwise with an madvise hint so that transparent huge
+ * pages can be used. Elsewhere, or if mapping fails, it comes from malloc.
  */
 
-void
-fifoqueue_put(Fifoqueue_Ptr queue_ptr, void * content_ptr)
+static Arena_Block_Ptr
+arena_block_new(Arena_Ptr arena, unsigned long size)
 {
-  Queue_Container_Ptr queue_container_ptr;
+  Arena_Block_Ptr new_block = NULL;
+  int mapped = 0;
+
+#ifdef __linux__
+  void * address;
+
+  if (arena->use_huge_pages) {
+#ifdef MAP_HUGETLB
+    address = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (address == MAP_FAILED)
+#endif
+      address = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (address != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+      madvise(address, size, MADV_HUGEPAGE);
+#endif
+      new_block = (Arena_Block_Ptr) address;
+      mapped = 1;
+    }
+  }
+#endif /* __linux__ */
 
-  queue_container_ptr = (Queue_Container_Ptr) xmalloc(sizeof(Queue_Container));
-  queue_container_ptr->content_ptr = content_ptr;
-  queue_container_ptr->next_ptr = NULL;
+  if (new_block == NULL) new_block = (Arena_Block_Ptr) xmalloc(size);
 
-  if (queue_ptr->size == 0) {
-    queue_ptr->front_ptr = queue_container_ptr;
-    queue_ptr->back_ptr =  queue_container_ptr;
-  }
-  else {
-    queue_ptr->back_ptr->next_ptr = queue_container_ptr;
-    queue_ptr->back_ptr = queue_container_ptr;
-  }
-  queue_ptr->size++;
+  new_block->size = size;
+  new_block->used = (sizeof(Arena_Block) + ARENA_ALIGNMENT - 1) &
+    ~(ARENA_ALIGNMENT - 1UL);
+  new_block->mapped = mapped;
+  new_block->next_block = arena->blocks;
+  arena->blocks = new_block;
+  return new_block;
 }
 
 /*
- * Take something out of a FIFO queue. Whatever it is should be cast to a void
- * pointer.
+ * Take size bytes from the arena. The memory is aligned to ARENA_ALIGNMENT and
+ * is not cleared. Requests too large for a normal block get one of their own.
  */
 
-void *
-fifoqueue_get(Fifoqueue_Ptr queue_ptr)
+static void *
+arena_alloc(Arena_Ptr arena, unsigned long size)
 {
-  Queue_Container_Ptr removed_container_ptr;
-  void* content_ptr;
-
-  if (queue_ptr->size > 0) {
-    removed_container_ptr = queue_ptr->front_ptr;
-    queue_ptr->front_ptr = removed_container_ptr->next_ptr;
-    content_ptr = removed_container_ptr->content_ptr;
-    free((char*) removed_container_ptr);
-
-    if(queue_ptr->size == 1) queue_ptr->back_ptr = NULL;
-    queue_ptr->size--;
-  }
-  else {
-    content_ptr = NULL;
+  Arena_Block_Ptr block;
+  unsigned long block_size;
+  void * memory;
+
+  size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1UL);
+  block = arena->blocks;
+
+  if (block == NULL || block->used + size > block->size) {
+    block_size = ARENA_BLOCK_SIZE;
+    if (size + sizeof(Arena_Block) + ARENA_ALIGNMENT > block_size) {
+      block_size = (size + sizeof(Arena_Block) + 2 * ARENA_ALIGNMENT +
+		    ARENA_BLOCK_SIZE - 1) & ~(ARENA_BLOCK_SIZE - 1);
+    }
+    block = arena_block_new(arena, block_size);
   }
-  return content_ptr;
+
+  memory = (char *) block + block->used;
+  block->used += size;
+  arena->bytes_allocated += size;
+  return memory;
 }
 
 /*
- * Get the number of objects currently in the Fifoqueue.
+ * Release an arena together with everything that was taken from it.
  */
 
-int
-fifoqueue_size(Fifoqueue_Ptr queue_ptr)
+static void
+arena_free(Arena_Ptr arena)
 {
-  return queue_ptr->size;
+  Arena_Block_Ptr next_block;
+
+  while (arena->blocks != NULL) {
+    next_block = arena->blocks->next_block;
+#ifdef __linux__
+    if (arena->blocks->mapped) munmap(arena->blocks, arena->blocks->size);
+    else
+#endif
+      xfree(arena->blocks);
+    arena->blocks = next_block;
+  }
+  xfree(arena);
 }
 
 /*
- * Get a pointer to the object at the front of the Fifoqueue.
+ * Allocate memory that lasts as long as the given simulation_run. It is taken
+ * from the run arena and must not be passed to free; it is released by
+ * simulation_run_free_memory.
  */
 
-void*
-fifoqueue_see_front(Fifoqueue_Ptr queue_ptr)
+void *
+simulation_run_alloc(Simulation_Run_Ptr simulation_run, unsigned long size)
 {
-  return queue_ptr->front_ptr->content_ptr;
+  return arena_alloc(simulation_run->arena, size);
 }
 
 /*
- * Server functions.
- *
- * Create and return a pointer to an empty server. The server is marked FREE.
+ * Ask for (nonzero) or stop asking for (zero) huge page backing of the arena
+ * blocks that a simulation_run takes from now on. The block taken when the run
+ * was created is not changed; use ARENA_HUGE_PAGES to have it backed by huge
+ * pages as well.
  */
 
-Server_Ptr
-server_new(void)
+void
+simulation_run_set_huge_pages(Simulation_Run_Ptr simulation_run,
+			      int use_huge_pages)
 {
-  Server_Ptr server_ptr;
-
-  server_ptr = (Server_Ptr) xmalloc(sizeof(Server));
-  server_ptr->customer_in_service = NULL;
-  server_ptr->state = FREE;
-  return server_ptr;
+  simulation_run->arena->use_huge_pages = use_huge_pages;
 }
 
 /*
- * Pass a server pointer and an object pointer to place the object in the
- * server. The server is marked BUSY.
+ * Return the number of bytes that have been taken from the run arena.
  */
 
-void
-server_put(Server_Ptr server, void* content_ptr)
+unsigned long
+simulation_run_arena_size(Simulation_Run_Ptr simulation_run)
 {
-  if (server_state(server) == BUSY) {
-      printf("Error: Cannot put into busy server.\n");
-      exit(1);
-    }
-
-  server->customer_in_service = content_ptr;
-  server->state = BUSY;
+  return simulation_run->arena->bytes_allocated;
 }
 
 /*
- * Remove whatever is in the server. The simulation_run will exit if this is
- * called when the server is FREE. So the server state should be tested first to
- * be sure.
+ * Functions for handling various event list operations.
+ *
+ * Create a new event list. This is called when a simulation_run is
+ * created. The event list is included in the simulation_run.
  */
 
-void *
-server_get(Server_Ptr server)
+static Eventlist_Ptr
+eventlist_new(Eventlist_Type eventlist_type)
 {
-  void *entry;
+  Eventlist_Ptr new_event_list;
 
-  if (server_state(server) == FREE) {
-      printf("Error: Cannot get from free server.\n");
-      exit(1);
-    }
+  new_event_list = (Eventlist_Ptr) xmalloc(sizeof(Eventlist));
 
-  entry = server->customer_in_service;
-  server->customer_in_service = NULL;
-  server->state = FREE;
-  return entry;
+  new_event_list->type = eventlist_type;
+  new_event_list->front_ptr = NULL;
+  new_event_list->back_ptr = NULL;
+  new_event_list->heap = NULL;
+  new_event_list->heap_capacity = 0;
+  new_event_list->calendar = NULL;
+  new_event_list->calendar_buckets = 0;
+  new_event_list->calendar_width = 1.0;
+  new_event_list->calendar_day = 0;
+  new_event_list->calendar_last_time = 0.0;
+  new_event_list->index_capacity = EVENTLIST_INDEX_MIN_SIZE;
+  new_event_list->index_bits = 0;
+  while ((1L << new_event_list->index_bits) < EVENTLIST_INDEX_MIN_SIZE)
+    new_event_list->index_bits++;
+  new_event_list->index = (Event_Container_Ptr *)
+    xcalloc(EVENTLIST_INDEX_MIN_SIZE, sizeof(Event_Container_Ptr));
+  new_event_list->size = 0;
+
+  if (eventlist_type == CALENDAR_EVENTLIST) {
+    new_event_list->calendar_buckets = CALENDAR_MIN_BUCKETS;
+    new_event_list->calendar = (Calendar_Bucket_Ptr)
+      xcalloc(CALENDAR_MIN_BUCKETS, sizeof(Calendar_Bucket));
+  }
+  return new_event_list;
 }
 
 /*
- * Test if the server is FREE or BUSY.
+ * Free an (empty) event list.
  */
 
-Server_State
-server_state(Server_Ptr a_server)
+static void
+eventlist_free(Eventlist_Ptr event_list)
 {
-  return(a_server->state);
+  if (event_list->heap != NULL) xfree(event_list->heap);
+  if (event_list->calendar != NULL) xfree(event_list->calendar);
+  xfree(event_list->index);
+  xfree(event_list);
 }
 
 /*
- * Random number generator functions.
+ * The following functions pass each event list operation on to the code for
+ * the type of event list being used.
  */
 
+static void
+eventlist_insert(Eventlist_Ptr event_list, Event_Container_Ptr new_container)
+{
+  switch (event_list->type) {
+  case HEAP_EVENTLIST:
+    heap_eventlist_insert(event_list, new_container);
+    break;
+  case CALENDAR_EVENTLIST:
+    calendar_eventlist_insert(event_list, new_container);
+    break;
+  default:
+    linked_eventlist_insert(event_list, new_container);
+    break;
+  }
+  eventlist_index_insert(event_list, new_container);
+  event_list->size++;
+}
+
+static void
+eventlist_remove(Eventlist_Ptr event_list, Event_Container_Ptr container)
+{
+  switch (event_list->type) {
+  case HEAP_EVENTLIST:
+    heap_eventlist_remove(event_list, container);
+    break;
+  case CALENDAR_EVENTLIST:
+    calendar_eventlist_remove(event_list, container);
+    break;
+  default:
+    linked_eventlist_remove(event_list, container);
+    break;
+  }
+  eventlist_index_remove(event_list, container);
+  event_list->size--;
+}
+
 /*
- * Functions for random streams, which permit multiple overlapping random number
- * generator streams (and seeds) at once.
+ * Remove and return the next event to occur.
  */
 
-Rand_Stream_Ptr
-rand_stream_new(unsigned seed)
+static Event_Container_Ptr
+eventlist_remove_front(Eventlist_Ptr event_list)
+{
+  Event_Container_Ptr top_container;
+
+  switch (event_list->type) {
+  case HEAP_EVENTLIST:
+    top_container = event_list->heap[0];
+    break;
+  case CALENDAR_EVENTLIST:
+    top_container = calendar_eventlist_front(event_list);
+    event_list->calendar_last_time = top_container->occurrence_time;
+    break;
+  default:
+    top_container = event_list->front_ptr;
+    break;
+  }
+  eventlist_remove(event_list, top_container);
+  return top_container;
+}
+
+/*
+ * Event id index functions. The index is an open addressing hash table of
+ * index_capacity = 2^index_bits slots holding pointers to the containers
+ * on the event list. Collisions are resolved by linear probing and the table
+ * is doubled whenever it becomes half full, so a lookup normally examines
+ * only one or two slots.
+ */
+
+static long int
+eventlist_index_slot(Eventlist_Ptr event_list, long int event_id)
+{
+  /*
+   * Fibonacci hashing: the top index_bits bits of the id times 2^64 divided
+   * by the golden ratio, which spreads out runs of consecutive ids.
+   */
+  return (long int) (((unsigned long long) event_id *
+		      11400714819323198485ULL) >> (64 - event_list->index_bits));
+}
+
+static void
+eventlist_index_grow(Eventlist_Ptr event_list)
+{
+  Event_Container_Ptr * old_index;
+  long int i, slot, old_capacity;
+
+  old_index = event_list->index;
+  old_capacity = event_list->index_capacity;
+
+  event_list->index_capacity = 2 * old_capacity;
+  event_list->index_bits++;
+  event_list->index = (Event_Container_Ptr *)
+    xcalloc((unsigned) event_list->index_capacity, sizeof(Event_Container_Ptr));
+
+  for (i=0; i<old_capacity; i++) {
+    if (old_index[i] == NULL) continue;
+    slot = eventlist_index_slot(event_list, old_index[i]->event_id);
+    while (event_list->index[slot] != NULL)
+      slot = (slot + 1) & (event_list->index_capacity - 1);
+    event_list->index[slot] = old_index[i];
+  }
+  xfree(old_index);
+}
+
+static void
+eventlist_index_insert(Eventlist_Ptr event_list,
+		       Event_Container_Ptr new_container)
+{
+  long int slot;
+
+  if (2 * (event_list->size + 1) > event_list->index_capacity)
+    eventlist_index_grow(event_list);
+
+  slot = eventlist_index_slot(event_list, new_container->event_id);
+  while (event_list->index[slot] != NULL)
+    slot = (slot + 1) & (event_list->index_capacity - 1);
+  event_list->index[slot] = new_container;
+}
+
+/*
+ * Remove a container from the index. Rather than leaving a tombstone, later
+ * entries in the same probe run are shifted back into the vacated slot when
+ * that is where their own search would reach first, so that the table never
+ * fills up with deleted slots.
+ */
+
+static void
+eventlist_index_remove(Eventlist_Ptr event_list, Event_Container_Ptr container)
+{
+  long int empty, slot, home, mask;
+
+  mask = event_list->index_capacity - 1;
+
+  empty = eventlist_index_slot(event_list, container->event_id);
+  while (event_list->index[empty] != container)
+    empty = (empty + 1) & mask;
+
+  slot = empty;
+  while (1) {
+    slot = (slot + 1) & mask;
+    if (event_list->index[slot] == NULL) break;
+    home = eventlist_index_slot(event_list, event_list->index[slot]->event_id);
+
+    /* Move the entry back unless its home lies cyclically in (empty, slot]. */
+    if (((slot - home) & mask) >= ((slot - empty) & mask)) {
+      event_list->index[empty] = event_list->index[slot];
+      empty = slot;
+    }
+  }
+  event_list->index[empty] = NULL;
+}
+
+/*
+ * Find the container holding a given event id. NULL is returned if the event
+ * is not on the event list.
+ */
+
+static Event_Container_Ptr
+eventlist_find(Eventlist_Ptr event_list, long int event_id)
+{
+  long int slot;
+
+  slot = eventlist_index_slot(event_list, event_id);
+  while (event_list->index[slot] != NULL) {
+    if (event_list->index[slot]->event_id == event_id)
+      return event_list->index[slot];
+    slot = (slot + 1) & (event_list->index_capacity - 1);
+  }
+  return NULL;
+}
+
+/*
+ * Test if event container a is to occur before event container b. Ties in
+ * occurrence time are broken using the event id so that simultaneous events
+ * occur in the order that they were scheduled, as they do on the linked list.
+ */
+
+static int
+event_precedes(Event_Container_Ptr a, Event_Container_Ptr b)
+{
+  if (a->occurrence_time != b->occurrence_time)
+    return a->occurrence_time < b->occurrence_time;
+  return a->event_id < b->event_id;
+}
+
+/*
+ * Linked event list functions. The event list is a doubly linked list kept in
+ * order of occurrence time.
+ */
+
+static void
+linked_eventlist_insert(Eventlist_Ptr event_list,
+			Event_Container_Ptr new_container)
+{
+  Event_Container_Ptr current_container, next_container;
+  double new_event_time;
+
+  new_event_time = new_container->occurrence_time;
+
+  if (event_list->size == 0) {
+    /* The list is empty. */
+    event_list->front_ptr = new_container;
+    event_list->back_ptr = new_container;
+    return;
+  }
+
+  if (event_list->front_ptr->occurrence_time > new_event_time) {
+    /* Add to front of the list. */
+    event_list->front_ptr->previous_container = new_container;
+    new_container->next_container = event_list->front_ptr;
+    event_list->front_ptr = new_container;
+    return;
+  }
+
+  if (event_list->back_ptr->occurrence_time <= new_event_time) {
+    /* Add to the back of the list. */
+    event_list->back_ptr->next_container = new_container;
+    new_container->previous_container = event_list->back_ptr;
+    event_list->back_ptr = new_container;
+    return;
+  }
+
+  /* Add to the middle of the list. */
+  current_container = event_list->front_ptr;
+  next_container = event_list->front_ptr->next_container;
+
+  while(next_container->occurrence_time <= new_event_time) {
+    current_container = next_container;
+    next_container = current_container->next_container;
+  }
+  current_container->next_container = new_container;
+  new_container->previous_container = current_container;
+  next_container->previous_container = new_container;
+  new_container->next_container = next_container;
+}
+
+static void
+linked_eventlist_remove(Eventlist_Ptr event_list,
+			Event_Container_Ptr found_container)
+{
+  Event_Container_Ptr next_container, previous_container;
+
+  previous_container = found_container->previous_container;
+  next_container = found_container->next_container;
+
+  /* Front of list. Adjust the front pointer. */
+  if (event_list->front_ptr == found_container)
+    event_list->front_ptr = next_container;
+
+  /* Back of list. Adjust the back pointer (could be both front and
+     back). */
+  if (event_list->back_ptr == found_container)
+    event_list->back_ptr = previous_container;
+
+  /* If the next event exists, adjust its previous event pointer. */
+  if (next_container != NULL)
+    next_container->previous_container = previous_container;
+
+  /* If the previous event exists, adjust its next event pointer. */
+  if (previous_container != NULL)
+    previous_container->next_container = next_container;
+
+  found_container->next_container = NULL;
+  found_container->previous_container = NULL;
+}
+
+/*
+ * Heap event list functions. The heap is stored in an array where the children
+ * of the container at position i are at positions EVENTLIST_HEAP_ARITY*i+1
+ * through EVENTLIST_HEAP_ARITY*i+EVENTLIST_HEAP_ARITY.
+ */
+
+#define HEAP_PARENT(i) (((i)-1)/EVENTLIST_HEAP_ARITY)
+#define HEAP_FIRST_CHILD(i) (EVENTLIST_HEAP_ARITY*(i)+1)
+
+/*
+ * Place a container at a heap position and record the position in the
+ * container.
+ */
+
+static void
+heap_set(Eventlist_Ptr event_list, long int index,
+	 Event_Container_Ptr container)
+{
+  event_list->heap[index] = container;
+  container->heap_index = index;
+}
+
+/*
+ * Move the container at position index up the heap until its parent occurs
+ * before it.
+ */
+
+static void
+heap_sift_up(Eventlist_Ptr event_list, long int index)
+{
+  Event_Container_Ptr container, parent;
+
+  container = event_list->heap[index];
+
+  while (index > 0) {
+    parent = event_list->heap[HEAP_PARENT(index)];
+    if (!event_precedes(container, parent)) break;
+    heap_set(event_list, index, parent);
+    index = HEAP_PARENT(index);
+  }
+  heap_set(event_list, index, container);
+}
+
+/*
+ * Move the container at position index down the heap until it occurs before
+ * all of its children. Only the first heap_size positions are part of the
+ * heap.
+ */
+
+static void
+heap_sift_down(Eventlist_Ptr event_list, long int index, long int heap_size)
+{
+  long int child, first_child, last_child, smallest;
+  Event_Container_Ptr container;
+
+  container = event_list->heap[index];
+
+  while ((first_child = HEAP_FIRST_CHILD(index)) < heap_size) {
+
+    last_child = first_child + EVENTLIST_HEAP_ARITY;
+    if (last_child > heap_size) last_child = heap_size;
+
+    smallest = first_child;
+    for (child=first_child+1; child<last_child; child++) {
+      if (event_precedes(event_list->heap[child], event_list->heap[smallest]))
+	smallest = child;
+    }
+
+    if (!event_precedes(event_list->heap[smallest], container)) break;
+    heap_set(event_list, index, event_list->heap[smallest]);
+    index = smallest;
+  }
+  heap_set(event_list, index, container);
+}
+
+static void
+heap_eventlist_insert(Eventlist_Ptr event_list,
+		      Event_Container_Ptr new_container)
+{
+  /* Grow the heap array if it is full. */
+  if (event_list->size == event_list->heap_capacity) {
+    event_list->heap_capacity =
+      (event_list->heap_capacity == 0) ? 64 : 2*event_list->heap_capacity;
+    event_list->heap = (Event_Container_Ptr *)
+      xrealloc(event_list->heap,
+	       event_list->heap_capacity * sizeof(Event_Container_Ptr));
+  }
+
+  heap_set(event_list, event_list->size, new_container);
+  heap_sift_up(event_list, event_list->size);
+}
+
+/*
+ * Remove a container from anywhere in the heap. The last container in the
+ * heap is moved into the vacated position and then sifted up or down as
+ * needed. The caller adjusts the event list size.
+ */
+
+static void
+heap_eventlist_remove(Eventlist_Ptr event_list,
+		      Event_Container_Ptr found_container)
+{
+  long int index, last;
+
+  index = found_container->heap_index;
+  last = event_list->size - 1;
+  found_container->heap_index = -1;
+
+  if (index == last) return;
+
+  heap_set(event_list, index, event_list->heap[last]);
+
+  if (index > 0 && event_precedes(event_list->heap[index],
+				 event_list->heap[HEAP_PARENT(index)])) {
+    heap_sift_up(event_list, index);
+  } else {
+    heap_sift_down(event_list, index, last);
+  }
+}
+
+/*
+ * Calendar queue event list functions. The calendar is an array of
+ * calendar_buckets buckets (a power of two), each holding a doubly linked list
+ * of containers kept in the same order as the heap. Time is divided into days
+ * of length calendar_width and an event occurring on day d is kept in bucket d
+ * modulo calendar_buckets. calendar_day is the day of the most recently
+ * removed event and no pending event occurs before it.
+ */
+
+static long long
+calendar_day_of(Eventlist_Ptr event_list, double time)
+{
+  return (long long) floor(time / event_list->calendar_width);
+}
+
+static Calendar_Bucket_Ptr
+calendar_bucket_of(Eventlist_Ptr event_list, long long day)
+{
+  return event_list->calendar + (day & (event_list->calendar_buckets - 1));
+}
+
+/*
+ * Place a container in its bucket, in order. New events usually occur after
+ * those already in the bucket, so the search starts at the back.
+ */
+
+static void
+calendar_bucket_insert(Eventlist_Ptr event_list,
+		       Event_Container_Ptr new_container)
+{
+  Calendar_Bucket_Ptr bucket;
+  Event_Container_Ptr current_container, next_container = NULL;
+
+  bucket = calendar_bucket_of(event_list,
+		  calendar_day_of(event_list, new_container->occurrence_time));
+
+  current_container = bucket->back_ptr;
+  while (current_container != NULL &&
+	 event_precedes(new_container, current_container)) {
+    next_container = current_container;
+    current_container = current_container->previous_container;
+  }
+
+  new_container->previous_container = current_container;
+  new_container->next_container = next_container;
+
+  if (current_container != NULL)
+    current_container->next_container = new_container;
+  else
+    bucket->front_ptr = new_container;
+
+  if (next_container != NULL)
+    next_container->previous_container = new_container;
+  else
+    bucket->back_ptr = new_container;
+}
+
+/*
+ * Take a container out of its bucket.
+ */
+
+static void
+calendar_bucket_remove(Eventlist_Ptr event_list,
+		       Event_Container_Ptr found_container)
+{
+  Calendar_Bucket_Ptr bucket;
+  Event_Container_Ptr next_container, previous_container;
+
+  bucket = calendar_bucket_of(event_list,
+		  calendar_day_of(event_list, found_container->occurrence_time));
+
+  previous_container = found_container->previous_container;
+  next_container = found_container->next_container;
+
+  if (previous_container != NULL)
+    previous_container->next_container = next_container;
+  else
+    bucket->front_ptr = next_container;
+
+  if (next_container != NULL)
+    next_container->previous_container = previous_container;
+  else
+    bucket->back_ptr = previous_container;
+
+  found_container->next_container = NULL;
+  found_container->previous_container = NULL;
+}
+
+/*
+ * Find the next event to occur without removing it. Starting at the current
+ * day, look through the buckets for one whose first event occurs on that
+ * day. If a whole year (one pass through the buckets) goes by without finding
+ * one, the events are sparse relative to the bucket width and the earliest
+ * event is found by looking at the front of every bucket. NULL is returned if
+ * the calendar is empty.
+ */
+
+static Event_Container_Ptr
+calendar_eventlist_front(Eventlist_Ptr event_list)
+{
+  long int i;
+  long long day;
+  Event_Container_Ptr head, earliest = NULL;
+
+  day = event_list->calendar_day;
+
+  for (i=0; i<event_list->calendar_buckets; i++, day++) {
+    head = calendar_bucket_of(event_list, day)->front_ptr;
+    if (head != NULL &&
+	calendar_day_of(event_list, head->occurrence_time) <= day) {
+      event_list->calendar_day = day;
+      return head;
+    }
+  }
+
+  for (i=0; i<event_list->calendar_buckets; i++) {
+    head = event_list->calendar[i].front_ptr;
+    if (head != NULL && (earliest == NULL || event_precedes(head, earliest)))
+      earliest = head;
+  }
+
+  if (earliest != NULL)
+    event_list->calendar_day =
+      calendar_day_of(event_list, earliest->occurrence_time);
+  return earliest;
+}
+
+/*
+ * Estimate a new bucket width from the separation of the next few events to
+ * occur, which are briefly taken off the calendar to find them. Following
+ * Brown, the width is three times the average separation after discarding
+ * separations more than twice the initial average. Zero is returned if there
+ * are too few events or they all occur at the same time.
+ */
+
+static double
+calendar_sample_width(Eventlist_Ptr event_list, int number_of_events)
+{
+  Event_Container_Ptr samples[CALENDAR_MAX_SAMPLES];
+  int i, number_of_samples, number_to_sample, count;
+  double average, total, separation;
+  long long saved_day;
+
+  number_to_sample = number_of_events <= 5 ? number_of_events :
+    5 + number_of_events/10;
+  if (number_to_sample > CALENDAR_MAX_SAMPLES)
+    number_to_sample = CALENDAR_MAX_SAMPLES;
+
+  saved_day = event_list->calendar_day;
+  number_of_samples = 0;
+  while (number_of_samples < number_to_sample &&
+	 (samples[number_of_samples] = calendar_eventlist_front(event_list))
+	 != NULL) {
+    calendar_bucket_remove(event_list, samples[number_of_samples++]);
+  }
+  for (i=0; i<number_of_samples; i++)
+    calendar_bucket_insert(event_list, samples[i]);
+  event_list->calendar_day = saved_day;
+
+  if (number_of_samples < 2) return 0.0;
+
+  average = (samples[number_of_samples-1]->occurrence_time -
+	     samples[0]->occurrence_time) / (number_of_samples - 1);
+
+  total = 0.0;
+  count = 0;
+  for (i=1; i<number_of_samples; i++) {
+    separation = samples[i]->occurrence_time - samples[i-1]->occurrence_time;
+    if (separation <= 2.0 * average) {
+      total += separation;
+      count++;
+    }
+  }
+
+  if (count == 0) return 0.0;
+  return 3.0 * total / count;
+}
+
+/*
+ * Rebuild the calendar, which holds number_of_events events, with a new number
+ * of buckets and a freshly estimated bucket width. When the sampled events all
+ * occur at the same time (which is common when times are quantized) the width
+ * is instead based on the average separation over the whole calendar.
+ */
+
+static void
+calendar_resize(Eventlist_Ptr event_list, long int new_buckets,
+		int number_of_events)
+{
+  Calendar_Bucket_Ptr old_calendar;
+  Event_Container_Ptr current_container, next_container;
+  long int i, old_buckets;
+  double new_width, earliest_time, latest_time;
+
+  old_calendar = event_list->calendar;
+  old_buckets = event_list->calendar_buckets;
+
+  new_width = calendar_sample_width(event_list, number_of_events);
+
+  if (new_width <= 0.0) {
+    earliest_time = latest_time = event_list->calendar_last_time;
+    for (i=0; i<old_buckets; i++) {
+      if (old_calendar[i].back_ptr != NULL &&
+	  old_calendar[i].back_ptr->occurrence_time > latest_time)
+	latest_time = old_calendar[i].back_ptr->occurrence_time;
+    }
+    if (latest_time > earliest_time && number_of_events > 0)
+      new_width = 3.0 * (latest_time - earliest_time) / number_of_events;
+    else
+      new_width = event_list->calendar_width;
+  }
+
+  event_list->calendar = (Calendar_Bucket_Ptr)
+    xcalloc((unsigned) new_buckets, sizeof(Calendar_Bucket));
+  event_list->calendar_buckets = new_buckets;
+  event_list->calendar_width = new_width;
+  event_list->calendar_day =
+    calendar_day_of(event_list, event_list->calendar_last_time);
+
+  for (i=0; i<old_buckets; i++) {
+    current_container = old_calendar[i].front_ptr;
+    while (current_container != NULL) {
+      next_container = current_container->next_container;
+      calendar_bucket_insert(event_list, current_container);
+      current_container = next_container;
+    }
+  }
+  xfree(old_calendar);
+}
+
+/*
+ * The calendar doubles in size when there are more than two events per
+ * bucket and halves when there are fewer than one event for every two
+ * buckets. The caller adjusts the event list size afterwards.
+ */
+
+static void
+calendar_eventlist_insert(Eventlist_Ptr event_list,
+			  Event_Container_Ptr new_container)
+{
+  calendar_bucket_insert(event_list, new_container);
+
+  if (event_list->size + 1 > 2*event_list->calendar_buckets)
+    calendar_resize(event_list, 2*event_list->calendar_buckets,
+		    event_list->size + 1);
+}
+
+static void
+calendar_eventlist_remove(Eventlist_Ptr event_list,
+			  Event_Container_Ptr found_container)
+{
+  calendar_bucket_remove(event_list, found_container);
+
+  if (event_list->size - 1 < event_list->calendar_buckets/2 &&
+      event_list->calendar_buckets > CALENDAR_MIN_BUCKETS)
+    calendar_resize(event_list, event_list->calendar_buckets/2,
+		    event_list->size - 1);
+}
+
+/*
+ * Get a pointer to the eventlist. This is intended for use only by simlib.
+ */
+
+static Eventlist_Ptr
+simulation_run_get_eventlist(Simulation_Run_Ptr simulation_run)
+{
+  return simulation_run->eventlist;
+}
+
+/*
+ * Some functions that are only needed if trace is enabled.
+ */
+
+#ifdef TRACE_ON
+
+static void
+event_print_type(Event event)
+{
+  printf("%s ", event.description);
+}
+
+#endif /* TRACE_ON */
+
+/*
+ * FIFO queue functions
+ *
+ * Make a new (empty) FIFO queue. This will return a pointer to the created
+ * Fifoqueue. The FIFO queue is a ring buffer of content pointers.
+ */
+
+Fifoqueue_Ptr
+fifoqueue_new(void)
+{
+  Fifoqueue_Ptr queue_id;
+
+  queue_id = (Fifoqueue_Ptr) xmalloc(sizeof(Fifoqueue));
+  queue_id->ring = (void **) xmalloc(FIFOQUEUE_MIN_CAPACITY * sizeof(void *));
+  queue_id->capacity = FIFOQUEUE_MIN_CAPACITY;
+  queue_id->front = 0;
+  queue_id->shrink = 0;
+  queue_id->size = 0;
+  return queue_id;
+}
+
+/*
+ * Move the contents of a FIFO queue into a new ring of the given capacity,
+ * with the front of the queue at slot 0.
+ */
+
+static void
+fifoqueue_resize(Fifoqueue_Ptr queue_ptr, long int new_capacity)
+{
+  void ** new_ring;
+  long int first_part;
+
+  new_ring = (void **) xmalloc(new_capacity * sizeof(void *));
+
+  /* The contents may wrap around the end of the old ring. */
+  first_part = queue_ptr->capacity - queue_ptr->front;
+  if (first_part > queue_ptr->size) first_part = queue_ptr->size;
+
+  memcpy(new_ring, queue_ptr->ring + queue_ptr->front,
+	 first_part * sizeof(void *));
+  memcpy(new_ring + first_part, queue_ptr->ring,
+	 (queue_ptr->size - first_part) * sizeof(void *));
+
+  xfree(queue_ptr->ring);
+  queue_ptr->ring = new_ring;
+  queue_ptr->capacity = new_capacity;
+  queue_ptr->front = 0;
+}
+
+/*
+ * Put something into a FIFO queue. Whatever it is should be cast to a void
+ * pointer.
+ */
+
+void
+fifoqueue_put(Fifoqueue_Ptr queue_ptr, void * content_ptr)
+{
+  if (queue_ptr->size == queue_ptr->capacity)
+    fifoqueue_resize(queue_ptr, 2 * queue_ptr->capacity);
+
+  queue_ptr->ring[(queue_ptr->front + queue_ptr->size) &
+		  (queue_ptr->capacity - 1)] = content_ptr;
+  queue_ptr->size++;
+}
+
+/*
+ * Take something out of a FIFO queue. Whatever it is should be cast to a void
+ * pointer.
+ */
+
+void *
+fifoqueue_get(Fifoqueue_Ptr queue_ptr)
+{
+  void* content_ptr;
+
+  if (queue_ptr->size > 0) {
+    content_ptr = queue_ptr->ring[queue_ptr->front];
+    queue_ptr->front = (queue_ptr->front + 1) & (queue_ptr->capacity - 1);
+    queue_ptr->size--;
+
+    if (queue_ptr->shrink && queue_ptr->capacity > FIFOQUEUE_MIN_CAPACITY &&
+	4 * queue_ptr->size <= queue_ptr->capacity)
+      fifoqueue_resize(queue_ptr, queue_ptr->capacity / 2);
+  }
+  else {
+    content_ptr = NULL;
+  }
+  return content_ptr;
+}
+
+/*
+ * Get the number of objects currently in the Fifoqueue.
+ */
+
+int
+fifoqueue_size(Fifoqueue_Ptr queue_ptr)
+{
+  return queue_ptr->size;
+}
+
+/*
+ * Get a pointer to the object at the front of the Fifoqueue. NULL is returned
+ * if the Fifoqueue is empty.
+ */
+
+void*
+fifoqueue_see_front(Fifoqueue_Ptr queue_ptr)
+{
+  if (queue_ptr->size == 0) return NULL;
+  return queue_ptr->ring[queue_ptr->front];
+}
+
+/*
+ * Turn shrinking of the ring buffer on (nonzero) or off (zero). It is off
+ * when a Fifoqueue is created, so the ring stays at its largest size.
+ */
+
+void
+fifoqueue_set_shrink(Fifoqueue_Ptr queue_ptr, int shrink)
+{
+  queue_ptr->shrink = shrink;
+}
+
+/*
+ * Free a Fifoqueue. Anything still on it should be removed and freed first.
+ */
+
+void
+fifoqueue_free(Fifoqueue_Ptr queue_ptr)
+{
+  xfree(queue_ptr->ring);
+  xfree(queue_ptr);
+}
+
+/*
+ * Intrusive FIFO queue functions.
+ *
+ * Make a new (empty) Linkqueue. The queue is a doubly linked list threaded
+ * through the Queue_Link embedded in each object on it, whose next_link and
+ * previous_link point to its neighbours.
+ */
+
+Linkqueue_Ptr
+linkqueue_new(void)
+{
+  Linkqueue_Ptr queue_id;
+
+  queue_id = (Linkqueue_Ptr) xmalloc(sizeof(Linkqueue));
+  queue_id->size = 0;
+  queue_id->front_ptr = NULL;
+  queue_id->back_ptr  = NULL;
+  return queue_id;
+}
+
+/*
+ * Put an object on a Linkqueue by passing a pointer to its Queue_Link. The
+ * object must not already be on a Linkqueue.
+ */
+
+void
+linkqueue_put(Linkqueue_Ptr queue_ptr, Queue_Link_Ptr link_ptr)
+{
+  link_ptr->next_link = NULL;
+  link_ptr->previous_link = queue_ptr->back_ptr;
+
+  if (queue_ptr->size == 0) {
+    queue_ptr->front_ptr = link_ptr;
+  }
+  else {
+    queue_ptr->back_ptr->next_link = link_ptr;
+  }
+  queue_ptr->back_ptr = link_ptr;
+  queue_ptr->size++;
+}
+
+/*
+ * Take the link at the front off a Linkqueue. NULL is returned if the queue is
+ * empty.
+ */
+
+Queue_Link_Ptr
+linkqueue_get(Linkqueue_Ptr queue_ptr)
+{
+  Queue_Link_Ptr link_ptr;
+
+  if (queue_ptr->size == 0) return NULL;
+
+  link_ptr = queue_ptr->front_ptr;
+  queue_ptr->front_ptr = link_ptr->next_link;
+  if (queue_ptr->size == 1) queue_ptr->back_ptr = NULL;
+  else queue_ptr->front_ptr->previous_link = NULL;
+  queue_ptr->size--;
+
+  link_ptr->next_link = NULL;
+  return link_ptr;
+}
+
+/*
+ * Get the number of objects currently in the Linkqueue.
+ */
+
+int
+linkqueue_size(Linkqueue_Ptr queue_ptr)
+{
+  return queue_ptr->size;
+}
+
+/*
+ * Get the link at the front of the Linkqueue without removing it. NULL is
+ * returned if the queue is empty.
+ */
+
+Queue_Link_Ptr
+linkqueue_see_front(Linkqueue_Ptr queue_ptr)
+{
+  return queue_ptr->front_ptr;
+}
+
+/*
+ * Take a link out of a Linkqueue, wherever it is in the queue. The link must
+ * be on this queue.
+ */
+
+void
+linkqueue_remove(Linkqueue_Ptr queue_ptr, Queue_Link_Ptr link_ptr)
+{
+  if (link_ptr->previous_link == NULL)
+    queue_ptr->front_ptr = link_ptr->next_link;
+  else
+    link_ptr->previous_link->next_link = link_ptr->next_link;
+
+  if (link_ptr->next_link == NULL)
+    queue_ptr->back_ptr = link_ptr->previous_link;
+  else
+    link_ptr->next_link->previous_link = link_ptr->previous_link;
+
+  queue_ptr->size--;
+
+  link_ptr->next_link = NULL;
+  link_ptr->previous_link = NULL;
+}
+
+/*
+ * Free a Linkqueue. The objects on it are not touched, so they should be taken
+ * off and freed first.
+ */
+
+void
+linkqueue_free(Linkqueue_Ptr queue_ptr)
+{
+  xfree(queue_ptr);
+}
+
+/*
+ * Object pool functions.
+ *
+ * Set up an empty Pool for objects of the given size, taking its pages from
+ * the given arena (or from malloc if it is NULL). The size is rounded up so
+ * that every object is suitably aligned and can hold the free list pointer
+ * while it is not in use.
+ */
+
+static void
+pool_initialize(Pool_Ptr pool, unsigned long object_size, Arena_Ptr arena)
+{
+  if (object_size < sizeof(void *)) object_size = sizeof(void *);
+  object_size = (object_size + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1UL);
+
+  pool->object_size = object_size;
+  pool->free_list = NULL;
+  pool->pages = NULL;
+  pool->arena = arena;
+  pool->page_count = 0;
+  pool->objects_in_use = 0;
+}
+
+/*
+ * Make a new (empty) Pool for objects of the given size.
+ */
+
+Pool_Ptr
+pool_new(unsigned long object_size)
+{
+  Pool_Ptr new_pool;
+
+  new_pool = (Pool_Ptr) xmalloc(sizeof(Pool));
+  pool_initialize(new_pool, object_size, NULL);
+  return new_pool;
+}
+
+/*
+ * Get an object from a Pool. Its contents are undefined.
+ */
+
+void *
+pool_get(Pool_Ptr pool)
+{
+  Pool_Page_Ptr new_page;
+  char * object;
+  void * object_ptr;
+  int i;
+
+  if (pool->free_list == NULL) {
+    if (pool->arena != NULL) {
+      /* Arena pages need no header since they are never freed singly. */
+      object = (char *) arena_alloc(pool->arena,
+				    POOL_PAGE_OBJECTS * pool->object_size);
+    }
+    else {
+      /* The objects follow the page header, which is padded for alignment. */
+      new_page = (Pool_Page_Ptr) xmalloc(POOL_ALIGNMENT +
+					 POOL_PAGE_OBJECTS * pool->object_size);
+      new_page->next_page = pool->pages;
+      pool->pages = new_page;
+      object = (char *) new_page + POOL_ALIGNMENT;
+    }
+    pool->page_count++;
+
+    object += (POOL_PAGE_OBJECTS - 1) * pool->object_size;
+    for (i=0; i<POOL_PAGE_OBJECTS; i++, object -= pool->object_size) {
+      *(void **) object = pool->free_list;
+      pool->free_list = (void *) object;
+    }
+  }
+
+  object_ptr = pool->free_list;
+  pool->free_list = *(void **) object_ptr;
+  pool->objects_in_use++;
+  return object_ptr;
+}
+
+/*
+ * Give an object back to the Pool it came from. As with free, a NULL pointer
+ * is ignored.
+ */
+
+void
+pool_put(Pool_Ptr pool, void * object_ptr)
+{
+  if (object_ptr == NULL) return;
+
+  *(void **) object_ptr = pool->free_list;
+  pool->free_list = object_ptr;
+  pool->objects_in_use--;
+}
+
+/*
+ * Free a Pool along with all of the objects that it has handed out. This does
+ * nothing for a Pool made by simulation_run_pool_new, since its memory belongs
+ * to the run arena.
+ */
+
+void
+pool_free(Pool_Ptr pool)
+{
+  Pool_Page_Ptr next_page;
+
+  if (pool->arena != NULL) return;
+
+  while (pool->pages != NULL) {
+    next_page = pool->pages->next_page;
+    xfree(pool->pages);
+    pool->pages = next_page;
+  }
+  xfree(pool);
+}
+
+/*
+ * Make a new (empty) Pool whose pages, like the Pool itself, are taken from
+ * the arena of the given simulation_run. Objects from it need not be given
+ * back before the run is freed.
+ */
+
+Pool_Ptr
+simulation_run_pool_new(Simulation_Run_Ptr simulation_run,
+			unsigned long object_size)
+{
+  Pool_Ptr new_pool;
+
+  new_pool = (Pool_Ptr) arena_alloc(simulation_run->arena, sizeof(Pool));
+  pool_initialize(new_pool, object_size, simulation_run->arena);
+  return new_pool;
+}
+
+/*
+ * Server functions.
+ *
+ * Create and return a pointer to an empty server. The server is marked FREE.
+ */
+
+Server_Ptr
+server_new(void)
+{
+  Server_Ptr server_ptr;
+
+  server_ptr = (Server_Ptr) xmalloc(sizeof(Server));
+  server_ptr->customer_in_service = NULL;
+  server_ptr->state = FREE;
+  return server_ptr;
+}
+
+/*
+ * Pass a server pointer and an object pointer to place the object in the
+ * server. The server is marked BUSY.
+ */
+
+void
+server_put(Server_Ptr server, void* content_ptr)
+{
+  if (server_state(server) == BUSY) {
+      printf("Error: Cannot put into busy server.\n");
+      exit(1);
+    }
+
+  server->customer_in_service = content_ptr;
+  server->state = BUSY;
+}
+
+/*
+ * Remove whatever is in the server. The simulation_run will exit if this is
+ * called when the server is FREE. So the server state should be tested first to
+ * be sure.
+ */
+
+void *
+server_get(Server_Ptr server)
+{
+  void *entry;
+
+  if (server_state(server) == FREE) {
+      printf("Error: Cannot get from free server.\n");
+      exit(1);
+    }
+
+  entry = server->customer_in_service;
+  server->customer_in_service = NULL;
+  server->state = FREE;
+  return entry;
+}
+
+/*
+ * Test if the server is FREE or BUSY.
+ */
+
+Server_State
+server_state(Server_Ptr a_server)
+{
+  return(a_server->state);
+}
+
+/*
+ * Server pool functions.
+ *
+ * Create a pool of the given number of servers, all FREE and idle.
+ */
+
+Server_Pool_Ptr
+server_pool_new(int number_of_servers)
+{
+  Server_Pool_Ptr pool;
+  int i;
+
+  pool = (Server_Pool_Ptr) xmalloc(sizeof(Server_Pool));
+  pool->servers = (Server_Ptr) xcalloc((unsigned) number_of_servers,
+				       sizeof(Server));
+  pool->idle_stack = (int *) xcalloc((unsigned) number_of_servers,
+				     sizeof(int));
+  pool->number_of_servers = number_of_servers;
+  pool->number_idle = number_of_servers;
+
+  /* Stack the servers so that server 0 is handed out first. */
+  for (i=0; i<number_of_servers; i++) {
+    pool->servers[i].state = FREE;
+    pool->servers[i].customer_in_service = NULL;
+    pool->idle_stack[i] = number_of_servers - 1 - i;
+  }
+  return pool;
+}
+
+/*
+ * Take an idle server from the pool. NULL is returned if every server is in
+ * use.
+ */
+
+Server_Ptr
+server_pool_acquire(Server_Pool_Ptr pool)
+{
+  if (pool->number_idle == 0) return NULL;
+  return pool->servers + pool->idle_stack[--pool->number_idle];
+}
+
+/*
+ * Give a server back to the pool that it came from. It must be FREE.
+ */
+
+void
+server_pool_release(Server_Pool_Ptr pool, Server_Ptr server)
+{
+  if (server < pool->servers ||
+      server >= pool->servers + pool->number_of_servers) {
+    printf("Error: Server does not belong to this server pool.\n");
+    exit(1);
+  }
+
+  if (server_state(server) == BUSY) {
+    printf("Error: Cannot release a busy server.\n");
+    exit(1);
+  }
+
+  if (pool->number_idle == pool->number_of_servers) {
+    printf("Error: Server released when every server is idle.\n");
+    exit(1);
+  }
+
+  pool->idle_stack[pool->number_idle++] = (int) (server - pool->servers);
+}
+
+/*
+ * Get the number of servers which have been acquired and not yet released.
+ */
+
+int
+server_pool_busy_count(Server_Pool_Ptr pool)
+{
+  return pool->number_of_servers - pool->number_idle;
+}
+
+/*
+ * Get a pointer to server i of the pool, e.g., to look at all of them.
+ */
+
+Server_Ptr
+server_pool_server(Server_Pool_Ptr pool, int i)
+{
+  return pool->servers + i;
+}
+
+/*
+ * Free a server pool. Any customers still in service should be removed and
+ * freed first.
+ */
+
+void
+server_pool_free(Server_Pool_Ptr pool)
+{
+  xfree(pool->servers);
+  xfree(pool->idle_stack);
+  xfree(pool);
+}
+
+/*
+ * Slot clock functions.
+ */
+
+/*
+ * The event at the start of a slot that has items. The slot number is found
+ * from the clock time, which is exactly slot * slot_duration.
+ */
+
+static void
+slot_clock_event(Simulation_Run_Ptr simulation_run, void * clock_ptr)
+{
+  Slot_Clock_Ptr clock;
+  long int slot, i;
+
+  clock = (Slot_Clock_Ptr) clock_ptr;
+  slot = (long int) floor(simulation_run_get_time(simulation_run) /
+			  clock->slot_duration + 0.5);
+
+  clock->current_slot = slot;
+  clock->resolve(simulation_run, clock, slot);
+
+  /* resolve may have added to later slots and grown the ring. */
+  i = slot % clock->number_of_buckets;
+  if (clock->bucket_slot[i] != slot) {
+    printf("Error: Slot %ld lost its bucket while being resolved.\n", slot);
+    exit(1);
+  }
+
+  if (fifoqueue_size(clock->buckets[i]) > 0) {
+    printf("Error: Slot %ld was resolved with items left in it.\n", slot);
+    exit(1);
+  }
+  clock->bucket_slot[i] = -1;
+}
+
+/*
+ * Double the ring of buckets, moving each one in use to its new place.
+ */
+
+static void
+slot_clock_grow(Slot_Clock_Ptr clock)
+{
+  Fifoqueue_Ptr * old_buckets;
+  long int * old_bucket_slot;
+  long int old_number, i, j;
+
+  old_buckets = clock->buckets;
+  old_bucket_slot = clock->bucket_slot;
+  old_number = clock->number_of_buckets;
+
+  clock->number_of_buckets = 2 * old_number;
+  clock->buckets = (Fifoqueue_Ptr *)
+    xcalloc(clock->number_of_buckets, sizeof(Fifoqueue_Ptr));
+  clock->bucket_slot = (long int *)
+    xcalloc(clock->number_of_buckets, sizeof(long int));
+
+  for (i=0; i<clock->number_of_buckets; i++) clock->bucket_slot[i] = -1;
+
+  /*
+   * Slots in different buckets differ modulo old_number, so they also differ
+   * modulo twice that, and each still has a bucket to itself.
+   */
+  for (i=0; i<old_number; i++) {
+    if (old_bucket_slot[i] >= 0) {
+      j = old_bucket_slot[i] % clock->number_of_buckets;
+      clock->buckets[j] = old_buckets[i];
+      clock->bucket_slot[j] = old_bucket_slot[i];
+    }
+  }
+
+  for (i=0; i<old_number; i++) {
+    if (old_bucket_slot[i] < 0) fifoqueue_free(old_buckets[i]);
+  }
+  for (i=0; i<clock->number_of_buckets; i++) {
+    if (clock->buckets[i] == NULL) clock->buckets[i] = fifoqueue_new();
+  }
+
+  xfree(old_buckets);
+  xfree(old_bucket_slot);
+}
+
+/*
+ * Create a slot clock for simulation_run with slots of slot_duration. resolve
+ * is called at the start of each slot that has items, and must take all of
+ * them out with slot_clock_get.
+ */
+
+Slot_Clock_Ptr
+slot_clock_new(Simulation_Run_Ptr simulation_run, double slot_duration,
+	       Slot_Function resolve)
+{
+  Slot_Clock_Ptr clock;
+  long int i;
+
+  if (slot_duration <= 0) {
+    printf("Error: Slot duration must be positive.\n");
+    exit(1);
+  }
+
+  clock = (Slot_Clock_Ptr) xmalloc(sizeof(Slot_Clock));
+  clock->simulation_run = simulation_run;
+  clock->resolve = resolve;
+  clock->slot_duration = slot_duration;
+  clock->current_slot = -1;
+  clock->number_of_buckets = SLOT_CLOCK_MIN_BUCKETS;
+  clock->buckets = (Fifoqueue_Ptr *)
+    xcalloc(clock->number_of_buckets, sizeof(Fifoqueue_Ptr));
+  clock->bucket_slot = (long int *)
+    xcalloc(clock->number_of_buckets, sizeof(long int));
+
+  for (i=0; i<clock->number_of_buckets; i++) {
+    clock->buckets[i] = fifoqueue_new();
+    clock->bucket_slot[i] = -1;
+  }
+  return clock;
+}
+
+/*
+ * Get the first slot that starts at or after time and has not yet been
+ * resolved.
+ */
+
+long int
+slot_clock_next_slot(Slot_Clock_Ptr clock, double time)
+{
+  long int slot;
+
+  slot = (long int) floor(time / clock->slot_duration);
+
+  /* Correct for rounding in the division. */
+  while (slot * clock->slot_duration < time) slot++;
+  while (slot > 0 && (slot - 1) * clock->slot_duration >= time) slot--;
+
+  if (slot <= clock->current_slot) slot = clock->current_slot + 1;
+  return slot;
+}
+
+/*
+ * Get the time at which a slot starts.
+ */
+
+double
+slot_clock_slot_time(Slot_Clock_Ptr clock, long int slot)
+{
+  return slot * clock->slot_duration;
+}
+
+/*
+ * Add an item to the bucket of a slot that has not yet been resolved. Items
+ * come out of a bucket in the order they were put in.
+ */
+
+void
+slot_clock_add(Slot_Clock_Ptr clock, long int slot, void * item)
+{
+  Event event;
+  long int i;
+
+  if (slot <= clock->current_slot) {
+    printf("Error: Slot %ld has already been resolved.\n", slot);
+    exit(1);
+  }
+
+  i = slot % clock->number_of_buckets;
+  while (clock->bucket_slot[i] >= 0 && clock->bucket_slot[i] != slot) {
+    slot_clock_grow(clock);
+    i = slot % clock->number_of_buckets;
+  }
+
+  if (clock->bucket_slot[i] < 0) {
+    clock->bucket_slot[i] = slot;
+
+    event.description = "Slot";
+    event.function = slot_clock_event;
+    event.attachment = (void *) clock;
+    simulation_run_schedule_event(clock->simulation_run, event,
+				  slot_clock_slot_time(clock, slot));
+  }
+
+  fifoqueue_put(clock->buckets[i], item);
+}
+
+/*
+ * Get the number of items in the bucket of a slot.
+ */
+
+int
+slot_clock_count(Slot_Clock_Ptr clock, long int slot)
+{
+  long int i;
+
+  i = slot % clock->number_of_buckets;
+  if (clock->bucket_slot[i] != slot) return 0;
+  return fifoqueue_size(clock->buckets[i]);
+}
+
+/*
+ * Take the next item out of the bucket of a slot. NULL is returned if the
+ * bucket is empty.
+ */
+
+void *
+slot_clock_get(Slot_Clock_Ptr clock, long int slot)
+{
+  long int i;
+
+  i = slot % clock->number_of_buckets;
+  if (clock->bucket_slot[i] != slot) return NULL;
+  return fifoqueue_get(clock->buckets[i]);
+}
+
+/*
+ * Free a slot clock. Items still in its buckets are not freed, and its
+ * pending events should not be executed afterwards.
+ */
+
+void
+slot_clock_free(Slot_Clock_Ptr clock)
+{
+  long int i;
+
+  for (i=0; i<clock->number_of_buckets; i++) fifoqueue_free(clock->buckets[i]);
+  xfree(clock->buckets);
+  xfree(clock->bucket_slot);
+  xfree(clock);
+}
+
+/*
+ * Random number generator functions.
+ */
+
+/*
+ * Functions for random streams, which permit multiple independent random
+ * number generator streams (and seeds) at once.
+ */
+
+Rand_Stream_Ptr
+rand_stream_new(unsigned seed)
+{
+  Rand_Stream_Ptr new_stream;
+
+  new_stream = (Rand_Stream_Ptr) xmalloc(sizeof(Rand_Stream));
+  rand_stream_initialize(new_stream, seed);
+  return new_stream;
+}
+
+/*
+ * Seed a stream. The 256-bit state is filled from the seed using splitmix64,
+ * as recommended for xoshiro, so that nearby seeds give unrelated streams and
+ * the state is never all zero.
+ */
+
+void
+rand_stream_initialize(Rand_Stream_Ptr rand_stream, unsigned seed)
+{
+  uint64_t x, z;
+  int i;
+
+  rand_stream->seed = seed;
+
+  x = (uint64_t) seed;
+  for (i=0; i<4; i++) {
+    z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    rand_stream->state[i] = z ^ (z >> 31);
+  }
+}
+
+static uint64_t
+rotate_left(uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+/*
+ * Return the next 64-bit number from a stream (xoshiro256++).
+ */
+
+uint64_t
+rand_stream_get(Rand_Stream_Ptr rand_stream)
+{
+  uint64_t * s = rand_stream->state;
+  uint64_t result, t;
+
+  result = rotate_left(s[0] + s[3], 23) + s[0];
+  t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotate_left(s[3], 45);
+
+  return result;
+}
+
+/*
+ * Generate a random number uniformly distributed over (0, 1). The top 52 bits
+ * of the next number, plus one half, are scaled by 2^-52 (see simlib.h for
+ * why 52 bits).
+ */
+
+double
+rand_stream_uniform_generator(Rand_Stream_Ptr rand_stream)
+{
+  return ((double) (rand_stream_get(rand_stream) >> 12) + 0.5) *
+    (1.0 / 4503599627370496.0);
+}
+
+double
+rand_stream_exponential_generator(Rand_Stream_Ptr rand_stream, double mean)
+{
+  return -1.0 * log(rand_stream_uniform_generator(rand_stream)) * mean;
+}
+
+/*
+ * Fill block with size samples, the same ones that size calls of
+ * rand_stream_uniform_generator or rand_stream_exponential_generator would
+ * give. The generator state is kept in local variables for the whole block,
+ * which makes these much faster than calling the generator per sample.
+ */
+
+void
+rand_stream_uniform_block(Rand_Stream_Ptr rand_stream, double * block,
+			  long int size)
+{
+  uint64_t s0, s1, s2, s3, result, t;
+  long int i;
+
+  s0 = rand_stream->state[0];
+  s1 = rand_stream->state[1];
+  s2 = rand_stream->state[2];
+  s3 = rand_stream->state[3];
+
+  for (i=0; i<size; i++) {
+    result = rotate_left(s0 + s3, 23) + s0;
+    t = s1 << 17;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rotate_left(s3, 45);
+
+    block[i] = ((double) (result >> 12) + 0.5) * (1.0 / 4503599627370496.0);
+  }
+
+  rand_stream->state[0] = s0;
+  rand_stream->state[1] = s1;
+  rand_stream->state[2] = s2;
+  rand_stream->state[3] = s3;
+}
+
+void
+rand_stream_exponential_block(Rand_Stream_Ptr rand_stream, double mean,
+			      double * block, long int size)
+{
+  long int i;
+
+  rand_stream_uniform_block(rand_stream, block, size);
+  for (i=0; i<size; i++) block[i] = -1.0 * log(block[i]) * mean;
+}
+
+/*
+ * The state update of xoshiro256 is linear over GF(2), so moving ahead j steps
+ * is multiplication of the state by T^j for the 256x256 update matrix T. Any
+ * power of T can be written as p(T), where p is x^j reduced modulo the
+ * characteristic polynomial of T (below, less its x^256 term), and p(T)
+ * applied to the state costs 256 steps of the generator. The polynomial for a
+ * jump of n substreams is found from x^(2^128) by repeated squaring.
+ */
+
+static const uint64_t XOSHIRO_CHARACTERISTIC_POLYNOMIAL[4] = {
+  0x9d116f2bb0f0f001ULL, 0x0280002bcefd1a5eULL,
+  0x04b4edcf26259f85ULL, 0x0003c03c3f3ecb19ULL
+};
+
+/* x^(2^128) modulo the characteristic polynomial (the standard xoshiro jump). */
+static const uint64_t XOSHIRO_SUBSTREAM_JUMP[4] = {
+  0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+  0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+};
+
+/*
+ * Multiply two polynomials over GF(2) modulo the characteristic polynomial.
+ * Bit i of a polynomial is its coefficient of x^i.
+ */
+
+static void
+gf2_polynomial_multiply(const uint64_t a[4], const uint64_t b[4],
+			uint64_t product[4])
+{
+  uint64_t shifted[4], result[4] = {0, 0, 0, 0}, carry;
+  int i, j;
+
+  for (j=0; j<4; j++) shifted[j] = a[j];
+
+  for (i=0; i<256; i++) {
+    if ((b[i/64] >> (i%64)) & 1) {
+      for (j=0; j<4; j++) result[j] ^= shifted[j];
+    }
+
+    /* Multiply shifted by x, reducing when the x^256 term appears. */
+    carry = shifted[3] >> 63;
+    for (j=3; j>0; j--) shifted[j] = (shifted[j] << 1) | (shifted[j-1] >> 63);
+    shifted[0] <<= 1;
+    if (carry) {
+      for (j=0; j<4; j++) shifted[j] ^= XOSHIRO_CHARACTERISTIC_POLYNOMIAL[j];
+    }
+  }
+
+  for (j=0; j<4; j++) product[j] = result[j];
+}
+
+/*
+ * Move a stream ahead by number_of_substreams * 2^128 numbers.
+ */
+
+void
+rand_stream_jump(Rand_Stream_Ptr rand_stream,
+		 unsigned long number_of_substreams)
+{
+  uint64_t jump[4] = {1, 0, 0, 0}, power[4], total[4] = {0, 0, 0, 0};
+  int i, j;
+
+  if (number_of_substreams == 0) return;
+
+  /* Raise x^(2^128) to the power number_of_substreams. */
+  for (j=0; j<4; j++) power[j] = XOSHIRO_SUBSTREAM_JUMP[j];
+  while (number_of_substreams > 0) {
+    if (number_of_substreams & 1) gf2_polynomial_multiply(jump, power, jump);
+    number_of_substreams >>= 1;
+    if (number_of_substreams > 0) gf2_polynomial_multiply(power, power, power);
+  }
+
+  /* Apply the jump polynomial to the state. */
+  for (i=0; i<256; i++) {
+    if ((jump[i/64] >> (i%64)) & 1) {
+      for (j=0; j<4; j++) total[j] ^= rand_stream->state[j];
+    }
+    rand_stream_get(rand_stream);
+  }
+
+  for (j=0; j<4; j++) rand_stream->state[j] = total[j];
+}
+
+/*
+ * Create a stream positioned at the start of the given substream of a seed.
+ * Streams made from the same seed with different substream numbers do not
+ * overlap.
+ */
+
+Rand_Stream_Ptr
+rand_stream_new_substream(unsigned seed, unsigned long substream)
 {
   Rand_Stream_Ptr new_stream;
 
-  new_stream = (Rand_Stream_Ptr) xmalloc(sizeof(Rand_Stream));
-  rand_stream_initialize(new_stream, seed);
-  return new_stream;
+  new_stream = rand_stream_new(seed);
+  rand_stream_jump(new_stream, substream);
+  return new_stream;
+}
+
+/*
+ * The global stream used by uniform_generator and exponential_generator. It
+ * starts out seeded with 1, as rand() does.
+ */
+
+static Rand_Stream global_rand_stream;
+static int global_rand_stream_seeded = 0;
+
+void
+random_generator_initialize(unsigned iseed)
+{
+  rand_stream_initialize(&global_rand_stream, iseed);
+  global_rand_stream_seeded = 1;
+}
+
+/*
+ * Generate a random number uniformly distributed over (0, 1).
+ */
+
+double
+uniform_generator(void)
+{
+  if (!global_rand_stream_seeded) random_generator_initialize(1);
+  return rand_stream_uniform_generator(&global_rand_stream);
+}
+
+/*
+ * Generate exponentially distributed random numbers.
+ */
+
+double
+exponential_generator(double mean)
+{
+  return -1.0 * log(uniform_generator()) * mean;
+}
+
+/*
+ * Functions for the random stream that belongs to a simulation_run. Seed the
+ * stream of a run before its first event is scheduled. A run that is not
+ * seeded uses the seed 1.
+ */
+
+void
+simulation_run_random_generator_initialize(Simulation_Run_Ptr simulation_run,
+					   unsigned iseed)
+{
+  rand_stream_initialize(simulation_run->rand_stream, iseed);
+}
+
+/*
+ * Return the stream of a run, e.g., to move it to one of its substreams with
+ * rand_stream_jump.
+ */
+
+Rand_Stream_Ptr
+simulation_run_rand_stream(Simulation_Run_Ptr simulation_run)
+{
+  return simulation_run->rand_stream;
+}
+
+double
+simulation_run_uniform_generator(Simulation_Run_Ptr simulation_run)
+{
+  return rand_stream_uniform_generator(simulation_run->rand_stream);
+}
+
+double
+simulation_run_exponential_generator(Simulation_Run_Ptr simulation_run,
+				     double mean)
+{
+  return rand_stream_exponential_generator(simulation_run->rand_stream, mean);
+}
+
+/*
+ * Batch means functions.
+ *
+ * Make a new Batch_Means whose batches start out holding batch_size
+ * observations each.
+ */
+
+Batch_Means_Ptr
+batch_means_new(long int batch_size)
+{
+  Batch_Means_Ptr new_batch_means;
+
+  new_batch_means = (Batch_Means_Ptr) xcalloc(1, sizeof(Batch_Means));
+  new_batch_means->batch_size = batch_size > 0 ? batch_size : 1;
+  new_batch_means->half_width = HUGE_VAL;
+  return new_batch_means;
+}
+
+/*
+ * Return the quantile of Student's t distribution with the given degrees of
+ * freedom for a two sided 95% confidence interval. Up to 30 degrees of freedom
+ * the value is taken from a table. Beyond that the normal quantile is
+ * corrected with the Cornish-Fisher expansion, which is accurate to about
+ * 1e-4 there.
+ */
+
+double
+student_t_quantile(long int degrees_of_freedom)
+{
+  static const double table[30] = {
+    12.7062, 4.3027, 3.1824, 2.7764, 2.5706, 2.4469, 2.3646, 2.3060, 2.2622,
+    2.2281, 2.2010, 2.1788, 2.1604, 2.1448, 2.1314, 2.1199, 2.1098, 2.1009,
+    2.0930, 2.0860, 2.0796, 2.0739, 2.0687, 2.0639, 2.0595, 2.0555, 2.0518,
+    2.0484, 2.0452, 2.0423
+  };
+  double z, z3, z5, z7, v;
+
+  if (degrees_of_freedom < 1) return HUGE_VAL;
+  if (degrees_of_freedom <= 30) return table[degrees_of_freedom - 1];
+
+  /* The normal quantile for a 95% interval. */
+  z = 1.959963984540054;
+  z3 = z * z * z;
+  z5 = z3 * z * z;
+  z7 = z5 * z * z;
+  v = (double) degrees_of_freedom;
+
+  return z + (z3 + z) / (4 * v) + (5 * z5 + 16 * z3 + 3 * z) / (96 * v * v) +
+    (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * v * v * v);
+}
+
+/*
+ * Recompute the half-width of the confidence interval from the complete
+ * batches.
+ */
+
+static void
+batch_means_update_half_width(Batch_Means_Ptr batch_means)
+{
+  long int i, n;
+  double mean = 0.0, variance = 0.0;
+
+  n = batch_means->number_of_batches;
+  if (n < BATCH_MEANS_MIN_BATCHES) {
+    batch_means->half_width = HUGE_VAL;
+    return;
+  }
+
+  for (i=0; i<n; i++) mean += batch_means->batch_means[i];
+  mean /= n;
+
+  for (i=0; i<n; i++) {
+    variance += (batch_means->batch_means[i] - mean) *
+      (batch_means->batch_means[i] - mean);
+  }
+  variance /= (n - 1);
+
+  batch_means->half_width =
+    student_t_quantile(n - 1) * sqrt(variance / n);
 }
 
+/*
+ * Add one observation.
+ */
+
 void
-rand_stream_initialize(Rand_Stream_Ptr rand_stream, unsigned seed)
+batch_means_add(Batch_Means_Ptr batch_means, double observation)
 {
-  rand_stream->rand_max = 32767;
-  rand_stream->seed  = seed;
-  rand_stream->next = seed;
+  long int i;
+
+  batch_means->count++;
+  batch_means->sum += observation;
+  batch_means->batch_sum += observation;
+
+  if (++batch_means->count_in_batch < batch_means->batch_size) return;
+
+  /* The current batch is complete. */
+  batch_means->batch_means[batch_means->number_of_batches++] =
+    batch_means->batch_sum / batch_means->batch_size;
+  batch_means->batch_sum = 0.0;
+  batch_means->count_in_batch = 0;
+
+  /* If every batch is full, merge them in pairs and double the batch size. */
+  if (batch_means->number_of_batches == BATCH_MEANS_MAX_BATCHES) {
+    for (i=0; i<BATCH_MEANS_MAX_BATCHES/2; i++) {
+      batch_means->batch_means[i] = (batch_means->batch_means[2*i] +
+				     batch_means->batch_means[2*i+1]) / 2;
+    }
+    batch_means->number_of_batches = BATCH_MEANS_MAX_BATCHES/2;
+    batch_means->batch_size *= 2;
+  }
+
+  batch_means_update_half_width(batch_means);
 }
 
 /*
- * Use our own code for rand so that we can make it thread-safe. This generator
- * is a pretty poor one but sufficient for our purposes.
+ * Return the number of observations, their mean, and the half-width of the
+ * confidence interval for the mean (HUGE_VAL if there are too few batches).
  */
 
-unsigned
-rand_stream_get(Rand_Stream_Ptr rand_stream)
+long int
+batch_means_count(Batch_Means_Ptr batch_means)
 {
-  rand_stream->next = rand_stream->next * 1103515245 + 12345;
-  return((unsigned)(rand_stream->next/65536) % rand_stream->rand_max);
+  return batch_means->count;
 }
 
 double
-rand_stream_uniform_generator(Rand_Stream_Ptr rand_stream)
+batch_means_mean(Batch_Means_Ptr batch_means)
+{
+  return batch_means->count > 0 ? batch_means->sum / batch_means->count : 0.0;
+}
+
+double
+batch_means_half_width(Batch_Means_Ptr batch_means)
+{
+  return batch_means->half_width;
+}
+
+/*
+ * Return true once the half-width of the confidence interval is no more than
+ * relative_precision times the mean. A relative_precision of zero or less
+ * never converges, so that a run goes to its full length.
+ */
+
+int
+batch_means_converged(Batch_Means_Ptr batch_means, double relative_precision)
+{
+  if (relative_precision <= 0) return 0;
+  return batch_means->half_width <=
+    relative_precision * fabs(batch_means_mean(batch_means));
+}
+
+void
+batch_means_free(Batch_Means_Ptr batch_means)
+{
+  xfree(batch_means);
+}
+
+/*
+ * Reset a Batch_Means to hold no observations, e.g., at the end of the
+ * warm-up period. The batch size goes back to batch_size.
+ */
+
+void
+batch_means_reset(Batch_Means_Ptr batch_means, long int batch_size)
+{
+  memset(batch_means, 0, sizeof(Batch_Means));
+  batch_means->batch_size = batch_size > 0 ? batch_size : 1;
+  batch_means->half_width = HUGE_VAL;
+}
+
+/*
+ * Warm-up detector functions (MSER-5).
+ */
+
+Warmup_Detector_Ptr
+warmup_detector_new(void)
+{
+  Warmup_Detector_Ptr new_detector;
+
+  new_detector = (Warmup_Detector_Ptr) xcalloc(1, sizeof(Warmup_Detector));
+  new_detector->capacity = WARMUP_MIN_BATCHES;
+  new_detector->batch_sums = (double *)
+    xmalloc(new_detector->capacity * sizeof(double));
+  new_detector->next_test = WARMUP_MIN_BATCHES;
+  new_detector->truncation_point = -1;
+  return new_detector;
+}
+
+/*
+ * Find the MSER truncation point, in batches, over the first half of the
+ * batch means. Sums over the tail Z_(d+1) .. Z_n are built up from the end so
+ * that every candidate costs O(1). -1 is returned if the minimum is at the
+ * end of the first half.
+ */
+
+static long int
+warmup_detector_truncation(Warmup_Detector_Ptr detector)
+{
+  long int n, d, best_d, half;
+  double sum = 0.0, sum_of_squares = 0.0, z, m, mser, best_mser;
+
+  n = detector->number_of_batches;
+  half = n / 2;
+
+  for (d=n-1; d>=half; d--) {
+    z = detector->batch_sums[d] / MSER_BATCH_SIZE;
+    sum += z;
+    sum_of_squares += z * z;
+  }
+
+  /* The tail sums now cover Z_(half+1) .. Z_n. */
+  m = (double) (n - half);
+  best_d = half;
+  best_mser = (sum_of_squares - sum * sum / m) / (m * m);
+
+  for (d=half-1; d>=0; d--) {
+    z = detector->batch_sums[d] / MSER_BATCH_SIZE;
+    sum += z;
+    sum_of_squares += z * z;
+    m = (double) (n - d);
+    mser = (sum_of_squares - sum * sum / m) / (m * m);
+    if (mser <= best_mser) {
+      best_mser = mser;
+      best_d = d;
+    }
+  }
+
+  return best_d < half ? best_d : -1;
+}
+
+/*
+ * Add one observation. True is returned on the call at which the end of the
+ * warm-up is detected.
+ */
+
+int
+warmup_detector_add(Warmup_Detector_Ptr detector, double observation)
+{
+  long int d, i;
+
+  if (detector->truncation_point >= 0) return 0;
+
+  detector->count++;
+  detector->batch_sum += observation;
+  if (++detector->count_in_batch < MSER_BATCH_SIZE) return 0;
+
+  if (detector->number_of_batches == detector->capacity) {
+    detector->capacity *= 2;
+    detector->batch_sums = (double *)
+      xrealloc(detector->batch_sums, detector->capacity * sizeof(double));
+  }
+  detector->batch_sums[detector->number_of_batches++] = detector->batch_sum;
+  detector->batch_sum = 0.0;
+  detector->count_in_batch = 0;
+
+  if (detector->number_of_batches < detector->next_test) return 0;
+  detector->next_test += detector->number_of_batches / 8;
+
+  if ((d = warmup_detector_truncation(detector)) < 0) return 0;
+
+  /*
+   * The warm-up is over. Only the sum of the observations before the
+   * truncation point is kept, for the caller to subtract.
+   */
+  detector->truncation_point = d * MSER_BATCH_SIZE;
+  for (i=0; i<d; i++) detector->truncated_sum += detector->batch_sums[i];
+  xfree(detector->batch_sums);
+  detector->batch_sums = NULL;
+  return 1;
+}
+
+/*
+ * Return true once the warm-up period has been found.
+ */
+
+int
+warmup_detector_done(Warmup_Detector_Ptr detector)
 {
-  double r;
+  return detector->truncation_point >= 0;
+}
 
-  do {
-    r = (double) rand_stream_get(rand_stream)/(double)rand_stream->rand_max;
-  } while (r == 1 || r == 0);
+/*
+ * Return the MSER-5 truncation point in observations (-1 if the warm-up has
+ * not been found yet), the sum of the observations before it, and the number
+ * of observations that had been seen when it was found.
+ */
 
-if (r > 1.0) {
-  printf ("***** ERROR: Random() out of bounds! ***** \n");
-  exit(0);
- } else return r;
+long int
+warmup_detector_truncation_point(Warmup_Detector_Ptr detector)
+{
+  return detector->truncation_point;
 }
 
 double
-rand_stream_exponential_generator(Rand_Stream_Ptr rand_stream, double mean)
+warmup_detector_truncated_sum(Warmup_Detector_Ptr detector)
 {
-  double u = 0.0;
+  return detector->truncated_sum;
+}
 
-  while (u == 0.0 || u == 1) u = rand_stream_uniform_generator(rand_stream);
-  return -1.0 * log(u) * mean;
+long int
+warmup_detector_count(Warmup_Detector_Ptr detector)
+{
+  return detector->count;
 }
 
 void
-random_generator_initialize(unsigned iseed)
+warmup_detector_free(Warmup_Detector_Ptr detector)
 {
-  srand(iseed);
+  if (detector->batch_sums != NULL) xfree(detector->batch_sums);
+  xfree(detector);
 }
 
 /*
- * Generate a random number uniformly distributed over (0, 1).
+ * Drift detector functions.
+ *
+ * Create a detector whose first windows use batches of batch_size
+ * observations.
+ */
+
+Drift_Detector_Ptr
+drift_detector_new(long int batch_size)
+{
+  Drift_Detector_Ptr new_detector;
+
+  new_detector = (Drift_Detector_Ptr) xcalloc(1, sizeof(Drift_Detector));
+  new_detector->batch_size = batch_size > 0 ? batch_size : 1;
+  return new_detector;
+}
+
+/*
+ * Fit a line to the batch means of a full window and decide whether it shows
+ * drift. The slope, per observation, is kept in the detector.
+ */
+
+static int
+drift_detector_window_drifts(Drift_Detector_Ptr detector)
+{
+  double n = DRIFT_WINDOW;
+  double x_mean = (n - 1) / 2;
+  double s_xx = n * (n * n - 1) / 12;
+  double y_mean = 0.0, s_xy = 0.0, s_yy = 0.0, slope, residual;
+  int i;
+
+  for (i=0; i<DRIFT_WINDOW; i++) y_mean += detector->window[i];
+  y_mean /= n;
+
+  for (i=0; i<DRIFT_WINDOW; i++) {
+    s_xy += (i - x_mean) * (detector->window[i] - y_mean);
+    s_yy += (detector->window[i] - y_mean) * (detector->window[i] - y_mean);
+  }
+
+  slope = s_xy / s_xx;
+  residual = (s_yy - slope * s_xy) / (n - 2);
+  if (residual < 0) residual = 0;
+
+  detector->slope = slope / detector->batch_size;
+
+  return slope > student_t_quantile(DRIFT_WINDOW - 2) * sqrt(residual / s_xx) &&
+    slope * (n - 1) >= DRIFT_MIN_RISE * fabs(y_mean);
+}
+
+/*
+ * Add an observation. Returns 1 on the observation at which the statistic is
+ * found to be unstable, and 0 otherwise.
+ */
+
+int
+drift_detector_add(Drift_Detector_Ptr detector, double value)
+{
+  if (detector->unstable) return 0;
+
+  detector->count++;
+  detector->batch_sum += value;
+  if (++detector->count_in_batch < detector->batch_size) return 0;
+
+  detector->window[detector->number_of_batches++] =
+    detector->batch_sum / detector->batch_size;
+  detector->batch_sum = 0.0;
+  detector->count_in_batch = 0;
+  if (detector->number_of_batches < DRIFT_WINDOW) return 0;
+
+  detector->number_of_batches = 0;
+  if (drift_detector_window_drifts(detector)) {
+    if (detector->confirmations++ == 0)
+      detector->first_slope = detector->slope;
+
+    if (detector->confirmations >= DRIFT_CONFIRMATIONS) {
+      if (detector->slope >= DRIFT_SLOPE_RATIO * detector->first_slope) {
+	detector->unstable = 1;
+	return 1;
+      }
+      detector->confirmations = 0;
+      detector->batch_size *= 2;
+    }
+  } else {
+    detector->confirmations = 0;
+    detector->batch_size *= 2;
+  }
+  return 0;
+}
+
+/*
+ * Return true if the statistic has been found to be unstable.
+ */
+
+int
+drift_detector_unstable(Drift_Detector_Ptr detector)
+{
+  return detector->unstable;
+}
+
+/*
+ * Return the growth of the statistic per observation over the last window
+ * that was tested.
  */
 
 double
-uniform_generator(void)
+drift_detector_slope(Drift_Detector_Ptr detector)
 {
-  double r;
+  return detector->slope;
+}
 
-  do {
-    r = (double) rand()/(double) RAND_MAX;
-  } while (r == 1 || r == 0);
+/*
+ * Return the number of observations added so far (up to the point of
+ * instability).
+ */
+
+long int
+drift_detector_count(Drift_Detector_Ptr detector)
+{
+  return detector->count;
+}
 
-if (r > 1.0) {
-  printf ("***** ERROR: Random() out of bounds! ***** \n");
-  exit(0);
- } else return r;
+void
+drift_detector_free(Drift_Detector_Ptr detector)
+{
+  xfree(detector);
 }
 
 /*
- * Generate exponentially distributed random numbers.
+ * Functions for running a parameter sweep, i.e., a grid of independent
+ * simulation_runs, on a pool of threads (see simlib.h).
+ */
+
+/*
+ * Return the number of threads that a sweep uses by default, which is the
+ * number of online processors.
+ */
+
+int
+sweep_thread_count(void)
+{
+#ifdef _WIN32
+  return 1;
+#else
+  long int count;
+
+  count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (int) count : 1;
+#endif
+}
+
+#ifndef _WIN32
+
+/*
+ * Each worker owns a deque holding the indices of the cells that it has yet
+ * to run. Cells are never added once the sweep has started, so a lock per
+ * deque is enough and is uncontended unless a steal is in progress.
+ */
+
+typedef struct _sweep_deque_
+{
+  pthread_mutex_t lock;
+  long int * cell_indices;
+  long int front;
+  long int back;
+} Sweep_Deque, * Sweep_Deque_Ptr;
+
+typedef struct _sweep_
+{
+  char * cells;
+  unsigned long cell_size;
+  Sweep_Cell_Function run_cell;
+  int number_of_workers;
+  Sweep_Deque_Ptr deques;
+} Sweep, * Sweep_Ptr;
+
+typedef struct _sweep_worker_
+{
+  Sweep_Ptr sweep;
+  int worker_index;
+  pthread_t thread;
+} Sweep_Worker, * Sweep_Worker_Ptr;
+
+/*
+ * Take a cell index from the back (the owner) or the front (a thief) of a
+ * deque. -1 is returned if the deque is empty.
+ */
+
+static long int
+sweep_deque_take(Sweep_Deque_Ptr deque, int from_back)
+{
+  long int cell = -1;
+
+  pthread_mutex_lock(&deque->lock);
+  if (deque->front < deque->back) {
+    if (from_back) {
+      cell = deque->cell_indices[--deque->back];
+    } else {
+      cell = deque->cell_indices[deque->front++];
+    }
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return cell;
+}
+
+/*
+ * The body of each worker thread. A worker runs the cells in its own deque and
+ * then steals from the others in turn. Since deques only ever shrink, the
+ * worker is finished once it finds every deque empty.
+ */
+
+static void *
+sweep_worker(void * ptr)
+{
+  Sweep_Worker_Ptr worker = (Sweep_Worker_Ptr) ptr;
+  Sweep_Ptr sweep = worker->sweep;
+  long int cell;
+  int i, victim;
+
+  while (1) {
+    cell = sweep_deque_take(sweep->deques + worker->worker_index, 1);
+
+    for (i=1; cell < 0 && i < sweep->number_of_workers; i++) {
+      victim = (worker->worker_index + i) % sweep->number_of_workers;
+      cell = sweep_deque_take(sweep->deques + victim, 0);
+    }
+
+    if (cell < 0) break;
+
+    sweep->run_cell((void *) (sweep->cells + cell * sweep->cell_size));
+  }
+  return NULL;
+}
+
+#endif /* _WIN32 */
+
+/*
+ * Run run_cell on each of the number_of_cells cells, each cell_size bytes
+ * long, in the array cells. run_cell is passed a pointer to its cell and the
+ * index of the cell. If number_of_threads is zero or less,
+ * sweep_thread_count() threads are used. sweep_run returns once every cell
+ * has been run.
+ */
+
+void
+sweep_run(void * cells, long int number_of_cells, unsigned long cell_size,
+	  Sweep_Cell_Function run_cell, int number_of_threads)
+{
+  long int cell;
+#ifndef _WIN32
+  Sweep sweep;
+  Sweep_Worker_Ptr workers;
+  int i;
+#endif
+
+  if (number_of_threads <= 0) number_of_threads = sweep_thread_count();
+  if (number_of_threads > number_of_cells) number_of_threads = number_of_cells;
+
+#ifndef _WIN32
+  if (number_of_threads > 1) {
+    sweep.cells = (char *) cells;
+    sweep.cell_size = cell_size;
+    sweep.run_cell = run_cell;
+    sweep.number_of_workers = number_of_threads;
+    sweep.deques = (Sweep_Deque_Ptr)
+      xcalloc(number_of_threads, sizeof(Sweep_Deque));
+    workers = (Sweep_Worker_Ptr)
+      xcalloc(number_of_threads, sizeof(Sweep_Worker));
+
+    /* Deal the cells out to the workers in turn. */
+    for (i=0; i<number_of_threads; i++) {
+      pthread_mutex_init(&sweep.deques[i].lock, NULL);
+      sweep.deques[i].cell_indices = (long int *)
+	xmalloc(((number_of_cells / number_of_threads) + 1) * sizeof(long int));
+    }
+    for (cell=0; cell<number_of_cells; cell++) {
+      i = cell % number_of_threads;
+      sweep.deques[i].cell_indices[sweep.deques[i].back++] = cell;
+    }
+
+    for (i=0; i<number_of_threads; i++) {
+      workers[i].sweep = &sweep;
+      workers[i].worker_index = i;
+      if (pthread_create(&workers[i].thread, NULL, sweep_worker,
+			 (void *) (workers + i)) != 0) {
+	printf("Error: Could not start sweep thread %d.\n", i);
+	exit(1);
+      }
+    }
+
+    for (i=0; i<number_of_threads; i++) {
+      pthread_join(workers[i].thread, NULL);
+      pthread_mutex_destroy(&sweep.deques[i].lock);
+      xfree((void *) sweep.deques[i].cell_indices);
+    }
+
+    xfree((void *) sweep.deques);
+    xfree((void *) workers);
+    return;
+  }
+#endif
+
+  for (cell=0; cell<number_of_cells; cell++) {
+    run_cell((void *) ((char *) cells + cell * cell_size));
+  }
+}
+
+/*
+ * Time-parallel departure recursion functions (see simlib.h).
+ */
+
+typedef struct _maxplus_chunk_
+{
+  const double * arrival;
+  const double * service;
+  double * departure;
+  long int size;
+} Maxplus_Chunk, * Maxplus_Chunk_Ptr;
+
+/*
+ * Run the recursion over one chunk starting from an empty queue. This is the
+ * parallel phase, run through sweep_run.
+ */
+
+static void
+maxplus_chunk_departures(void * chunk_ptr)
+{
+  Maxplus_Chunk_Ptr chunk = (Maxplus_Chunk_Ptr) chunk_ptr;
+  double departure = -HUGE_VAL;
+  long int i;
+
+  for (i=0; i<chunk->size; i++) {
+    departure = (chunk->arrival[i] > departure ? chunk->arrival[i] :
+		 departure) + chunk->service[i];
+    chunk->departure[i] = departure;
+  }
+}
+
+/*
+ * Compute the departure times of number_of_customers customers with the
+ * given arrival and service times. initial_departure is the departure time of
+ * the customer before the first (-HUGE_VAL if there is none). If
+ * number_of_threads is zero or less, sweep_thread_count() threads are used.
+ * The departure time of the last customer is returned.
  */
 
 double
-exponential_generator(double mean)
+maxplus_departures(const double * arrival, const double * service,
+		   double * departure, long int number_of_customers,
+		   double initial_departure, int number_of_threads)
+{
+  Maxplus_Chunk_Ptr chunks;
+  long int number_of_chunks, chunk_size, first, i;
+  double d = initial_departure;
+  long int c;
+
+  if (number_of_threads <= 0) number_of_threads = sweep_thread_count();
+
+  if (number_of_threads == 1 || number_of_customers < 2) {
+    for (i=0; i<number_of_customers; i++) {
+      d = (arrival[i] > d ? arrival[i] : d) + service[i];
+      departure[i] = d;
+    }
+    return d;
+  }
+
+  number_of_chunks = (long int) number_of_threads * MAXPLUS_CHUNKS_PER_THREAD;
+  if (number_of_chunks > number_of_customers)
+    number_of_chunks = number_of_customers;
+  chunk_size = (number_of_customers + number_of_chunks - 1) / number_of_chunks;
+  number_of_chunks = (number_of_customers + chunk_size - 1) / chunk_size;
+
+  chunks = (Maxplus_Chunk_Ptr) xcalloc(number_of_chunks, sizeof(Maxplus_Chunk));
+  for (c=0; c<number_of_chunks; c++) {
+    first = c * chunk_size;
+    chunks[c].arrival = arrival + first;
+    chunks[c].service = service + first;
+    chunks[c].departure = departure + first;
+    chunks[c].size = number_of_customers - first < chunk_size ?
+      number_of_customers - first : chunk_size;
+  }
+
+  /* Every chunk on its own, in parallel. */
+  sweep_run((void *) chunks, number_of_chunks, sizeof(Maxplus_Chunk),
+	    maxplus_chunk_departures, number_of_threads);
+
+  /* Correct the start of each chunk until it couples with the local run. */
+  for (c=0; c<number_of_chunks; c++) {
+    for (i=0; i<chunks[c].size; i++) {
+      d = (chunks[c].arrival[i] > d ? chunks[c].arrival[i] : d) +
+	chunks[c].service[i];
+      if (d == chunks[c].departure[i]) break;
+      chunks[c].departure[i] = d;
+    }
+    d = chunks[c].departure[chunks[c].size - 1];
+  }
+
+  xfree((void *) chunks);
+  return d;
+}
+
+/*
+ * Compute the departure times of a tandem line of number_of_stations FIFO
+ * queues. service[k] and departure[k] hold the service and departure times at
+ * station k. last_departure[k] gives the departure time at station k of the
+ * customer before the first, and is updated to that of the last customer, so
+ * that a long run can be processed in segments.
+ */
+
+void
+maxplus_tandem_departures(const double * arrival, double ** service,
+			  double ** departure, int number_of_stations,
+			  long int number_of_customers, double * last_departure,
+			  int number_of_threads)
 {
-  double u = 0.0;
+  int k;
 
-  while (u == 0.0 || u == 1) u = uniform_generator();
-  return -1.0 * log(u) * mean;
+  for (k=0; k<number_of_stations; k++) {
+    last_departure[k] =
+      maxplus_departures(k == 0 ? arrival : departure[k-1], service[k],
+			 departure[k], number_of_customers, last_departure[k],
+			 number_of_threads);
+  }
 }
 
 /*
@@ -702,6 +3179,22 @@ xcalloc(unsigned num, unsigned size)
   }
 }
 
+/*
+ * Create a front-end for realloc that performs out-of-memory testing.
+ */
+
+void *
+xrealloc(void * ptr, unsigned long size)
+{
+  void * a_ptr;
+
+  if((a_ptr = (void *) realloc(ptr, size)) != NULL) return a_ptr;
+  else {
+    printf("***** ERROR: Out of memory ***** \n");
+    exit(1);
+  }
+}
+
 /*
  * Create a front-end for free that checks for null pointers.
  */
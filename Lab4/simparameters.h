@@ -32,10 +32,18 @@
 #define MEAN_SLOT_DURATION 1     /* slot reservation Tx time */
 #define PACKET_ARRIVAL_RATE 0.5  /* packets per Tx time */
 #define MEAN_BACKOFF_DURATION 10    /* in units of packet transmit time, Tx */
-#define RUNLENGTH 10e6
+#define RUNLENGTH 10e6            /* upper limit on packets per run */
+#define RELATIVE_PRECISION 0.01   /* stop at this 95% CI half-width/mean, 0 = off */
+#define BATCH_SIZE 1000           /* initial batch size for the delay CI */
 #define BLIPRATE 10e3
 #define epsilon 0.0001
 
+/*
+ * Run the reservation channel on whole slots of MEAN_SLOT_DURATION with a
+ * Slot_Clock (simlib.h) instead of start and end events nudged by epsilon.
+ */
+#define USE_SLOTTED_TIME 0
+
 /* Comma separated list of random seeds to run. */
 #define RANDOM_SEED_LIST 400167784
 
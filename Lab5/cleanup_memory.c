@@ -38,44 +38,27 @@ void
 cleanup_memory (Simulation_Run_Ptr simulation_run)
 {
   Simulation_Run_Data_Ptr data;
-  Fifoqueue_Ptr buffer;
-  Fifoqueue_Ptr buffer2;
-  Fifoqueue_Ptr buffer3;
-  Server_Ptr link;
-  Server_Ptr link2;
-  Server_Ptr link3;
 
   data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
 
-  buffer = data->device1;
-  buffer2 = data->device2;
-  buffer3 = data->cloud_server;
+  /*
+   * The packets, whether in a buffer, on a link or attached to an event, come
+   * from the run pool and are released along with the simulation_run, so only
+   * the links and buffers themselves need to be freed here.
+   */
 
-  link = data->link;
-  link2 = data->link2;
-  link3 = data->link3;
+  xfree(data->link);
+  xfree(data->link2);
+  xfree(data->link3);
 
-  if(link->state == BUSY) /* Clean out the server. */
-    xfree(server_get(link));
-  xfree(link);
+  fifoqueue_free(data->device1);
+  fifoqueue_free(data->device2);
+  fifoqueue_free(data->cloud_server);
 
-  if(link2->state == BUSY) /* Clean out the server. */
-    xfree(server_get(link2));
-  xfree(link2);
-
-  if(link3->state == BUSY) /* Clean out the server. */
-    xfree(server_get(link3));
-  xfree(link3);
-
-  while (fifoqueue_size(buffer) > 0) /* Clean out the queue. */
-    xfree(fifoqueue_get(buffer));
-  xfree(buffer);
-  while (fifoqueue_size(buffer2) > 0) /* Clean out the queue. */
-    xfree(fifoqueue_get(buffer2));
-  xfree(buffer2);
-  while (fifoqueue_size(buffer3) > 0) /* Clean out the queue. */
-    xfree(fifoqueue_get(buffer3));
-  xfree(buffer3);
+  warmup_detector_free(data->warmup);
+  warmup_detector_free(data->warmup2);
+  drift_detector_free(data->drift);
+  drift_detector_free(data->drift2);
 
   simulation_run_free_memory(simulation_run); /* Clean up the simulation_run. */
 }
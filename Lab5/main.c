@@ -106,12 +106,30 @@ main(void)
         data.link  = server_new();
         data.link2 = server_new();
         data.link3 = server_new();
+        data.packet_pool = simulation_run_pool_new(simulation_run,
+                                                   sizeof(Packet));
+
+        /*
+         * Each device's delays get their own warm-up detector.
+         */
+
+        data.warmup = warmup_detector_new();
+        data.warmup2 = warmup_detector_new();
+
+        /*
+         * The run is stopped if the delays of either device grow without
+         * bound.
+         */
+
+        data.drift = drift_detector_new(DRIFT_BATCH_SIZE);
+        data.drift2 = drift_detector_new(DRIFT_BATCH_SIZE);
+        data.unstable_device = 0;
 
         /*
          * Set the random number generator seed for this run.
          */
 
-        random_generator_initialize(random_seed);
+        simulation_run_random_generator_initialize(simulation_run, random_seed);
 
         /*
          * Schedule the initial packet arrival for the current clock time (= 0).
@@ -123,7 +141,7 @@ main(void)
          * Execute events until we are finished.
          */
 
-        while(data.number_of_packets_processed < RUNLENGTH && data.number_of_packets_processed2 < RUNLENGTH && data.number_of_packets_processed3 < RUNLENGTH) {
+        while(data.number_of_packets_processed < RUNLENGTH && data.number_of_packets_processed2 < RUNLENGTH && data.number_of_packets_processed3 < RUNLENGTH && data.unstable_device == 0) {
             simulation_run_execute_event(simulation_run);
         }
 
@@ -42,6 +42,12 @@ typedef struct _simulation_run_data_
   Server_Ptr link;
   Server_Ptr link2;
   Server_Ptr link3;
+  Pool_Ptr packet_pool;
+  Warmup_Detector_Ptr warmup;
+  Warmup_Detector_Ptr warmup2;
+  Drift_Detector_Ptr drift;
+  Drift_Detector_Ptr drift2;
+  int unstable_device;
 
   int arrival_rate;
   int arrival_rate23;
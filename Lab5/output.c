@@ -79,6 +79,13 @@ output_results(Simulation_Run_Ptr simulation_run)
 
     printf("\n");
     printf("Random Seed = %d \n\n", data->random_seed);
+
+    if(data->unstable_device != 0) {
+        printf("UNSTABLE: the delay of Device %d grows by %.3g seconds per packet. The run was stopped at time %.3f and the results below are not steady state.\n\n",
+         data->unstable_device,
+         drift_detector_slope(data->unstable_device == 1 ? data->drift : data->drift2),
+         simulation_run_get_time(simulation_run));
+    }
     printf("Packet arrivals on Device 1 = %ld \n", data->arrival_count);
     printf("Packet arrivals on Device 2 = %ld \n", data->arrival_count2);
 
@@ -93,6 +100,11 @@ output_results(Simulation_Run_Ptr simulation_run)
     printf("Transmitted packet count on Device 2  = %ld (Service Fraction = %.5f)\n",
      data->number_of_packets_processed2, xmtted_fraction2);
 
+    printf("Warm-up packets discarded on Device 1 = %ld \n",
+     warmup_detector_done(data->warmup) ? warmup_detector_truncation_point(data->warmup) : 0);
+    printf("Warm-up packets discarded on Device 2 = %ld \n\n",
+     warmup_detector_done(data->warmup2) ? warmup_detector_truncation_point(data->warmup2) : 0);
+
     printf("Mean Delay for Origin @ Switch 1(msec) = %.2f \n",
      1e3*data->accumulated_delay/data->number_of_packets_processed);
     printf("Mean Delay for Origin @ Switch 2(msec) = %.2f \n",
@@ -68,9 +68,9 @@ packet_arrival_event(Simulation_Run_Ptr simulation_run, void * ptr)
     Packet_Ptr new_packet;
 
     data = (Simulation_Run_Data_Ptr) simulation_run_data(simulation_run);
-    random_device_id = (int) floor(uniform_generator()*NUMBER_OF_DEVICES);
+    random_device_id = (int) floor(simulation_run_uniform_generator(simulation_run)*NUMBER_OF_DEVICES);
 
-    new_packet = (Packet_Ptr) xmalloc(sizeof(Packet));
+    new_packet = (Packet_Ptr) pool_get(data->packet_pool);
     new_packet->arrive_time = simulation_run_get_time(simulation_run);
     new_packet->status = WAITING;
     new_packet->sourceDevice = random_device_id;
@@ -106,7 +106,7 @@ packet_arrival_event(Simulation_Run_Ptr simulation_run, void * ptr)
 
     schedule_packet_arrival_event(simulation_run,
             simulation_run_get_time(simulation_run) +
-            exponential_generator((double) 1/PACKET_ARRIVAL_RATE));
+            simulation_run_exponential_generator(simulation_run, (double) 1/PACKET_ARRIVAL_RATE));
 }
 
 
@@ -102,8 +102,19 @@ end_packet_transmission_event(Simulation_Run_Ptr simulation_run, void * link)
         if(this_packet->sourceDevice == 0){
             data->accumulated_delay += simulation_run_get_time(simulation_run) - this_packet->arrive_time;
             data->number_of_packets_processed++;
+
+            /* Roll the statistics back to the end of the warm-up period. */
+            if(warmup_detector_add(data->warmup, simulation_run_get_time(simulation_run) - this_packet->arrive_time)) {
+                data->arrival_count -= warmup_detector_truncation_point(data->warmup);
+                data->number_of_packets_processed -= warmup_detector_truncation_point(data->warmup);
+                data->accumulated_delay -= warmup_detector_truncated_sum(data->warmup);
+            }
+
+            if(drift_detector_add(data->drift, simulation_run_get_time(simulation_run) - this_packet->arrive_time)) {
+                data->unstable_device = 1;
+            }
             output_progress_msg_to_screen(simulation_run);
-            xfree((void *) this_packet);
+            pool_put(data->packet_pool, (void *) this_packet);
             if(fifoqueue_size(data->cloud_server) > 0) {
                 next_packet = (Packet_Ptr) fifoqueue_get(data->cloud_server);
                 start_transmission_on_link(simulation_run, next_packet, link);
@@ -111,8 +122,19 @@ end_packet_transmission_event(Simulation_Run_Ptr simulation_run, void * link)
         } else {
             data->accumulated_delay2 += simulation_run_get_time(simulation_run) - this_packet->arrive_time;
             data->number_of_packets_processed2++;
+
+            /* Roll the statistics back to the end of the warm-up period. */
+            if(warmup_detector_add(data->warmup2, simulation_run_get_time(simulation_run) - this_packet->arrive_time)) {
+                data->arrival_count2 -= warmup_detector_truncation_point(data->warmup2);
+                data->number_of_packets_processed2 -= warmup_detector_truncation_point(data->warmup2);
+                data->accumulated_delay2 -= warmup_detector_truncated_sum(data->warmup2);
+            }
+
+            if(drift_detector_add(data->drift2, simulation_run_get_time(simulation_run) - this_packet->arrive_time)) {
+                data->unstable_device = 2;
+            }
             output_progress_msg_to_screen(simulation_run);
-            xfree((void *) this_packet);
+            pool_put(data->packet_pool, (void *) this_packet);
             if(fifoqueue_size(data->cloud_server) > 0) {
                 next_packet = (Packet_Ptr) fifoqueue_get(data->cloud_server);
                 start_transmission_on_link(simulation_run, next_packet, link);
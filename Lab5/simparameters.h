@@ -34,6 +34,9 @@
 #define LINK_BIT_RATE 1e6 /* bits per second */
 #define RUNLENGTH 10e6 /* packets */
 
+/* Packets per batch when checking the delays for instability. */
+#define DRIFT_BATCH_SIZE 1000
+
 /* Comma separated list of random seeds to run. */
 #define RANDOM_SEED_LIST 400167784
 